@@ -1,5 +1,13 @@
 #pragma once
 
+#include <cstring>
+#include <cfloat>
+
+// math.h and stdlib.h, for the float overloads of abs, floor, etc. in the
+// global namespace.
+#include <math.h>
+#include <stdlib.h>
+
 
 template <typename T>
 T min(T a, T b) {
@@ -4,6 +4,8 @@
 #include <common/math.hpp>
 #include "lina.hpp"
 
+#include <algorithm>
+
 template <typename T, Uint n>
 struct Poly;
 
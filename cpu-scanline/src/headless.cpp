@@ -0,0 +1,227 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include <common/common.hpp>
+#include <common/math.hpp>
+
+#include "scanline.hpp"
+#include "scene.hpp"
+#include "svg.hpp"
+
+#include <chrono>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
+
+
+// renders an svg scene to a png without a window, and prints how long
+// parsing and each stage of the pipeline take per path.
+//
+// usage: headless [-scale s] [-iterations n] [-quiet] [-o out.png] [scene.svg]
+//
+// the scene defaults to tiger.svg. the times are the minimum over the
+// iterations. compute_winding runs
+// inside find_boundary_fragments, for each fragment as it is emitted, so its
+// time is part of the fragments column.
+
+
+struct Stage_Times {
+    Float64 monotone;
+    Float64 fragments;
+    Float64 sort;
+    Float64 rasterize;
+};
+
+inline Float64 get_time_us() {
+    auto now = std::chrono::high_resolution_clock::now().time_since_epoch();
+    return Float64(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count()) / 1000.0;
+}
+
+
+int main(int argc, char** argv) {
+    auto scale       = 1.0f;
+    auto iterations  = Uint(1);
+    auto quiet       = false;
+    auto output_path = "out.png";
+    auto scene_path  = "tiger.svg";
+
+    for(auto i = 1; i < argc; i += 1) {
+        auto has_value = i + 1 < argc;
+        if(strcmp(argv[i], "-scale") == 0 && has_value) {
+            scale = Float32(atof(argv[i + 1]));
+            i += 1;
+        }
+        else if(strcmp(argv[i], "-iterations") == 0 && has_value) {
+            iterations = max(Uint(atoi(argv[i + 1])), Uint(1));
+            i += 1;
+        }
+        else if(strcmp(argv[i], "-o") == 0 && has_value) {
+            output_path = argv[i + 1];
+            i += 1;
+        }
+        else if(strcmp(argv[i], "-quiet") == 0) {
+            quiet = true;
+        }
+        else if(argv[i][0] != '-') {
+            scene_path = argv[i];
+        }
+        else {
+            printf("usage: %s [-scale s] [-iterations n] [-quiet] [-o out.png] [scene.svg]\n", argv[0]);
+            return 1;
+        }
+    }
+
+
+    auto text = List<char>();
+    if(!read_file(scene_path, text)) {
+        printf("could not read %s\n", scene_path);
+        return 1;
+    }
+
+    auto scene = List<Tiger_Path>();
+    auto parse_us = Float64(FLT_MAX);
+    for(auto iteration : Range<Uint>(iterations)) {
+        UNUSED(iteration);
+
+        scene.clear();
+        auto t0 = get_time_us();
+        auto parse_result = parse_svg(text.data(), text.size(), scene);
+        auto t1 = get_time_us();
+        if(!parse_result) {
+            printf("could not parse %s\n", scene_path);
+            return 1;
+        }
+        parse_us = min(parse_us, t1 - t0);
+    }
+
+
+    auto scene_aabb = Rect{ V2f(+FLT_MAX, +FLT_MAX), V2f(-FLT_MAX, -FLT_MAX) };
+    for(const auto& path : scene) {
+        scene_aabb = get_union(scene_aabb, compute_aabb(path.path.curves));
+    }
+
+    // an empty scene gives an image of just the padding.
+    if(scene.empty()) {
+        scene_aabb = Rect { V2f(0.0f, 0.0f), V2f(0.0f, 0.0f) };
+    }
+
+    scene_aabb.min = scale*scene_aabb.min;
+    scene_aabb.max = scale*scene_aabb.max;
+
+    auto padding    = V2f(20.0f, 20.0f);
+    auto offset     = -scene_aabb.min + padding;
+    auto image_size = ceil(scene_aabb.max - scene_aabb.min + 2.f*padding);
+
+    for(auto& path : scene) {
+        for(auto& curve : path.path.curves) {
+            for(auto i : Range<Uint>(curve.degree + 1)) {
+                curve[i] = scale*curve[i] + offset;
+            }
+        }
+    }
+
+    auto stroke_t0 = get_time_us();
+    auto scene_strokes = List<List<Generic_Bezier>>(scene.size());
+    for(auto i : range_of(scene)) {
+        auto half_width = scale*scene[i].stroke_width/2.0f;
+        scene_strokes[i] = compute_stroke(
+            scene[i].path,
+            half_width, half_width,
+            0.0f
+        );
+    }
+    auto stroke_us = get_time_us() - stroke_t0;
+
+    auto image_width  = Sint32(image_size.x);
+    auto image_height = Sint32(image_size.y);
+    auto image = List<Uint8>(Uint(4*image_width)*Uint(image_height));
+
+
+    auto totals = Stage_Times();
+
+    auto draw_path = [&](Uint index, const char* kind, const List<Generic_Bezier>& path, Color color) {
+        auto rgba = to_rgba8(color);
+
+        auto best = Stage_Times { FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX };
+        auto fragment_count = Uint();
+
+        // rasterize appends to problem_lines every time, keep one
+        // iteration's problems.
+        auto problem_count = problem_lines.size();
+
+        // fill_span overwrites, so drawing the same path again gives the
+        // same image.
+        for(auto iteration : Range<Uint>(iterations)) {
+            UNUSED(iteration);
+            problem_lines.resize(problem_count);
+
+            auto t0 = get_time_us();
+            auto curve_cuts = find_monotone_segments(path);
+            auto t1 = get_time_us();
+            auto fragments = find_boundary_fragments(path, curve_cuts);
+            auto t2 = get_time_us();
+            sort_boundary_fragments(fragments);
+            auto t3 = get_time_us();
+            rasterize(fragments,
+                [&](Sint32 x0, Sint32 x1, Sint32 y) {
+                    fill_span(image.data(), image_width, image_height, x0, x1, y, rgba);
+                },
+                [&](Sint32 x, Sint32 y) {
+                    fill_span(image.data(), image_width, image_height, x, x + 1, y, rgba);
+                }
+            );
+            auto t4 = get_time_us();
+
+            best.monotone  = min(best.monotone,  t1 - t0);
+            best.fragments = min(best.fragments, t2 - t1);
+            best.sort      = min(best.sort,      t3 - t2);
+            best.rasterize = min(best.rasterize, t4 - t3);
+            fragment_count = fragments.size();
+        }
+
+        totals.monotone  += best.monotone;
+        totals.fragments += best.fragments;
+        totals.sort      += best.sort;
+        totals.rasterize += best.rasterize;
+
+        if(!quiet) {
+            printf("%4u %-6s %6u %8u %12.3f %12.3f %12.3f %12.3f\n",
+                unsigned(index), kind, unsigned(path.size()), unsigned(fragment_count),
+                best.monotone, best.fragments, best.sort, best.rasterize
+            );
+        }
+    };
+
+    if(!quiet) {
+        printf("path kind   curves fragments  monotone_us fragments_us      sort_us rasterize_us\n");
+    }
+
+    for(auto i : range_of(scene)) {
+        current_path = i;
+        defer { current_path = Uint(-1); };
+        const auto& path = scene[i];
+        if(path.fill.a > 0.f) {
+            draw_path(i, "fill", path.path.curves, path.fill);
+        }
+        if(path.stroke.a > 0.f) {
+            draw_path(i, "stroke", scene_strokes[i], path.stroke);
+        }
+    }
+
+    auto total_us = totals.monotone + totals.fragments + totals.sort + totals.rasterize;
+    printf("paths:                   %u\n", unsigned(scene.size()));
+    printf("problems:                %u\n", unsigned(problem_lines.size()));
+    printf("parse_svg:               %.3f us (%.1f MB/s)\n", parse_us, Float64(text.size())/parse_us);
+    printf("compute_stroke:          %.3f us\n", stroke_us);
+    printf("find_monotone_segments:  %.3f us\n", totals.monotone);
+    printf("find_boundary_fragments: %.3f us (includes compute_winding)\n", totals.fragments);
+    printf("sort_boundary_fragments: %.3f us\n", totals.sort);
+    printf("rasterize:               %.3f us\n", totals.rasterize);
+    printf("total:                   %.3f us\n", total_us);
+
+    auto write_result = stbi_write_png(output_path, image_width, image_height, 4, image.data(), 4*image_width);
+    if(write_result == 0) {
+        printf("could not write %s\n", output_path);
+        return 1;
+    }
+
+    return 0;
+}
@@ -29,6 +29,7 @@ union V2 {
 };
 
 using V2f = V2<Float32>;
+using V2d = V2<Float64>;
 using V2s = V2<Sint32>;
 using V2u = V2<Uint32>;
 
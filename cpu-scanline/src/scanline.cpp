@@ -0,0 +1,739 @@
+#include "scanline.hpp"
+
+
+List<V2s> problem_lines;
+Uint current_path = Uint(-1);
+
+
+
+Generic_Bezier generic_line(V2f p0, V2f p1) {
+    auto result = Generic_Bezier();
+    result.degree = 1;
+    result.values[0] = p0;
+    result.values[1] = p1;
+    return result;
+}
+
+Generic_Bezier generic_quadratic(V2f p0, V2f p1, V2f p2) {
+    auto result = Generic_Bezier();
+    result.degree = 2;
+    result.values[0] = p0;
+    result.values[1] = p1;
+    result.values[2] = p2;
+    return result;
+}
+
+Generic_Bezier generic_cubic(V2f p0, V2f p1, V2f p2, V2f p3) {
+    auto result = Generic_Bezier();
+    result.degree = 3;
+    result.values[0] = p0;
+    result.values[1] = p1;
+    result.values[2] = p2;
+    result.values[3] = p3;
+    return result;
+}
+
+
+Bezier<V2f, 0> get_bezier_0(const Generic_Bezier& curve) {
+    assert(curve.degree == 0);
+    return Bezier<V2f, 0>{ curve.values[0] };
+}
+
+Bezier<V2f, 1> get_bezier_1(const Generic_Bezier& curve) {
+    assert(curve.degree == 1);
+    return Bezier<V2f, 1>{ curve.values[0], curve.values[1] };
+}
+
+Bezier<V2f, 2> get_bezier_2(const Generic_Bezier& curve) {
+    assert(curve.degree == 2);
+    return Bezier<V2f, 2>{ curve.values[0], curve.values[1], curve.values[2] };
+}
+
+Bezier<V2f, 3> get_bezier_3(const Generic_Bezier& curve) {
+    assert(curve.degree == 3);
+    return Bezier<V2f, 3>{ curve.values[0], curve.values[1], curve.values[2], curve.values[3] };
+}
+
+
+V2f evaluate_bernstein(const Generic_Bezier& curve, Float32 t) {
+    switch (curve.degree) {
+        case 0: { return evaluate_bernstein(get_bezier_0(curve), t); } break;
+        case 1: { return evaluate_bernstein(get_bezier_1(curve), t); } break;
+        case 2: { return evaluate_bernstein(get_bezier_2(curve), t); } break;
+        case 3: { return evaluate_bernstein(get_bezier_3(curve), t); } break;
+
+        default: throw Exception();
+    }
+}
+
+V2f evaluate_casteljau(const Generic_Bezier& curve, Float32 t) {
+    switch (curve.degree) {
+        case 0: { return evaluate_casteljau(get_bezier_0(curve), t); } break;
+        case 1: { return evaluate_casteljau(get_bezier_1(curve), t); } break;
+        case 2: { return evaluate_casteljau(get_bezier_2(curve), t); } break;
+        case 3: { return evaluate_casteljau(get_bezier_3(curve), t); } break;
+
+        default: throw Exception();
+    }
+}
+
+V2f evaluate(const Generic_Bezier& curve, Float32 t) {
+    return evaluate_casteljau(curve, t);
+}
+
+
+
+Uint find_derivative_roots(const Generic_Bezier& curve, Uint32 axis, Float32& t0, Float32& t1) {
+    auto root_count = Uint();
+    switch(curve.degree) {
+        case 0: case 1: {
+            root_count = 0;
+        } break;
+
+        case 2: {
+            auto bezier = get_bezier_2(curve);
+            auto component_bezier = get_component_bezier(bezier, axis);
+            auto derivative = derive<Float32>(component_bezier);
+            auto poly = get_poly<Float32>(derivative);
+            root_count = find_roots(poly, t0, zero_tolerance);
+        } break;
+
+        case 3: {
+            auto bezier = get_bezier_3(curve);
+            auto component_bezier = get_component_bezier(bezier, axis);
+            auto derivative = derive<Float32>(component_bezier);
+            auto poly = get_poly<Float32>(derivative);
+            root_count = find_roots(poly, t0, t1, zero_tolerance);
+        } break;
+        default: throw Exception();
+    }
+    return root_count;
+}
+
+
+
+void print(const Bezier<V2f, 1>& bezier) {
+    printf(
+        "segment((%f, %f), (%f, %f)), ",
+        bezier[0][0], bezier[0][1],
+        bezier[1][0], bezier[1][1]
+    );
+}
+
+void print(const Bezier<V2f, 2>& bezier) {
+    printf(
+        "curve( "
+        "  %f*(1-t)^2 "
+        "+ 2*%f*(1-t)*t "
+        "+ %f*t^2, "
+        "  %f*(1-t)^2 "
+        "+ 2*%f*(1-t)*t "
+        "+ %f*t^2, "
+        "t, 0, 1), ",
+        bezier[0][0], bezier[1][0], bezier[2][0],
+        bezier[0][1], bezier[1][1], bezier[2][1]
+    );
+}
+
+void print(const Bezier<V2f, 3>& bezier) {
+    printf(
+        "curve( "
+        "  %f*(1-t)^3 "
+        "+ 3*%f*(1-t)^2*t "
+        "+ 3*%f*(1-t)*t^2 "
+        "+ %f*t^3, "
+        "  %f*(1-t)^3 "
+        "+ 3*%f*(1-t)^2*t "
+        "+ 3*%f*(1-t)*t^2 "
+        "+ %f*t^3, "
+        "t, 0, 1), ",
+        bezier[0][0], bezier[1][0], bezier[2][0], bezier[3][0],
+        bezier[0][1], bezier[1][1], bezier[2][1], bezier[3][1]
+    );
+}
+
+void print(const Generic_Bezier& curve) {
+    switch(curve.degree) {
+        case 1: print(get_bezier_1(curve)); break;
+        case 2: print(get_bezier_2(curve)); break;
+        case 3: print(get_bezier_3(curve)); break;
+        default: assert(false);
+    }
+}
+
+
+
+List<Generic_Bezier> compute_stroke(
+    const List<Generic_Bezier>& path, Bool is_closed,
+    Float32 left_offset, Float32 right_offset,
+    Float32 tolerance
+) {
+    UNUSED(tolerance);
+
+    // degree reduction.
+    auto outline = List<Generic_Bezier>();
+    for(const auto& curve : path) {
+        if(curve.degree == 3) {
+            auto quads = reduce_degree(get_bezier_3(curve), 0.1f);
+            for(const auto& q : quads) {
+                outline.push_back(generic_quadratic(q[0], q[1], q[2]));
+            }
+        }
+        else {
+            outline.push_back(curve);
+        }
+    }
+
+    // offsetting.
+    auto left_outline  = List<Generic_Bezier>();
+    auto right_outline = List<Generic_Bezier>();
+    for(auto i : range_of(outline)) {
+        const auto& curve = outline[i];
+
+        if(curve.degree == 1) {
+            auto bezier = get_bezier_1(curve);
+            // TODO: zero precision?
+            if(length_squared(bezier[1] - bezier[0]) == 0.0f) {
+                left_outline.push_back(curve);
+                right_outline.push_back(curve);
+            }
+            else {
+                auto n = rotate_ccw(normalized(bezier[1] - bezier[0]));
+                left_outline. push_back(generic_line(bezier[0] + left_offset*n,  bezier[1] + left_offset*n));
+                right_outline.push_back(generic_line(bezier[0] - right_offset*n, bezier[1] - right_offset*n));
+            }
+        }
+        else if(curve.degree == 2) {
+            auto bezier = get_bezier_2(curve);
+            auto l = offset(bezier, +left_offset, zero_tolerance);
+            auto r = offset(bezier, -right_offset, zero_tolerance);
+            left_outline. push_back(generic_quadratic(l[0], l[1], l[2]));
+            right_outline.push_back(generic_quadratic(r[0], r[1], r[2]));
+        }
+        else {
+            assert(false);
+        }
+    }
+
+    // compute stroke by connecting end points.
+    auto stroke = List<Generic_Bezier>();
+    for(auto i : range_of(left_outline)) {
+        const auto& current = left_outline[i];
+
+        if(i > 0) {
+            const auto& prev = left_outline[i - 1];
+            stroke.push_back(generic_line(prev[prev.degree], current[0]));
+        }
+
+        stroke.push_back(current);
+    }
+    for(auto i : range_of(right_outline)) {
+        auto current = right_outline[i];
+
+        if(i > 0) {
+            const auto& prev = right_outline[i - 1];
+            stroke.push_back(generic_line(current[0], prev[prev.degree]));
+        }
+
+        std::reverse(&current.values[0], &current.values[current.degree + 1]);
+        stroke.push_back(current);
+    }
+
+    // Bevel cap.
+    if(is_closed && outline.size() > 1) {
+        const auto& first_left = first(left_outline);
+        const auto& last_left  = last(left_outline);
+        stroke.push_back(generic_line(last_left[last_left.degree], first_left[0]));
+
+        const auto& first_right = first(right_outline);
+        const auto& last_right  = last(right_outline);
+        stroke.push_back(generic_line(first_right[0], last_right[last_right.degree]));
+    }
+    // Bevel join.
+    else {
+        const auto& first_left  = first(left_outline);
+        const auto& first_right = first(right_outline);
+        stroke.push_back(generic_line(first_right[0], first_left[0]));
+
+        const auto& last_left  = last(left_outline);
+        const auto& last_right = last(right_outline);
+        stroke.push_back(generic_line(last_left[last_left.degree], last_right[last_right.degree]));
+    }
+
+    return stroke;
+}
+
+Array<Cut, max_cut_count> find_monotone_segments(const Generic_Bezier& curve) {
+    auto cuts = Array<Cut, max_cut_count>();
+
+    for(auto axis : Range<Uint32>(2)) {
+        auto cuts_begin = axis*max_cuts_per_axis;
+
+        auto& cut_0 = cuts[cuts_begin + 0];
+        auto& cut_1 = cuts[cuts_begin + 1];
+        // Initialize cuts to make sorting work.
+        cut_0.t    = cut_1.t    = 1.f;
+        cut_0.axis = cut_1.axis = axis;
+
+        find_derivative_roots(curve, axis, cut_0.t, cut_1.t);
+    }
+
+    // Sort cuts by t. (We have to sort the entire array. Eg: [1, 1, 0.5, 0.75])
+    insertion_sort(make_slice(cuts), [](const auto& a, const auto& b) { return a.t <= b.t; });
+
+    return cuts;
+}
+
+
+List<Array<Cut, max_cut_count>> find_monotone_segments(const List<Generic_Bezier>& path) {
+    auto curve_cuts = List<Array<Cut, max_cut_count>>(path.size());
+    for(auto curve_index : range_of(path)) {
+        curve_cuts[curve_index] = find_monotone_segments(path[curve_index]);
+    }
+    return curve_cuts;
+}
+
+
+void compute_winding(Boundary_Fragment& fragment, V2s position, V2f p0, V2f p1) {
+    auto normalized_0 = p0 - V2f(position);
+    auto normalized_1 = p1 - V2f(position);
+
+    // Sort coordinates by y to make hit testing curve direction independent.
+    // In particular: If two consecutive segments end at y = 0.5, only one
+    // should be hit by the ray if they have the same winding, or both if
+    // they have opposite windings. (hit segment joint vs cusp)
+    auto test_0 = normalized_0;
+    auto test_1 = normalized_1;
+    if(p1.y - p0.y < 0.0f) {
+        swap(test_0, test_1);
+    }
+
+    auto ray_0 = min(0.0f, min(normalized_0.x, normalized_1.x));
+    auto ray_1 = max(1.0f, max(normalized_0.x, normalized_1.x));
+
+    auto intersect_ray = [=](V2f r0, V2f r1) {
+        auto ts = V2f();
+        // TODO: should we use a tolerance here?
+        if(find_lines_intersection(r0, r1, test_0, test_1, &ts, zero_tolerance) == false) {
+            return false;
+        }
+
+        // NOTE: Use half open interavl [0; 1) to avoid overlap.  Tolerance
+        // does not make sense here, as it would just offset the cut-off
+        // line.
+        // What is important however is that the path does not contain holes
+        // between consecutive curves. (Splitting should be fine: always
+        // have t = 0, t = 1 and each t1 is the t0 of another segment.)
+        auto ray_t = ts[0];
+        auto line_t = ts[1];
+        return in_interval_inclusive(ray_t, 0.0f, 1.0f, zero_tolerance)
+            && in_interval_left_inclusive(line_t, 0.0f, 1.0f, zero_tolerance);
+        //return in_interval_inclusive(ray_t, 0.0f, 1.0f)
+            //&& line_t >= 0 && line_t <= 1.0f - zero_tolerance;
+            //&& in_interval_left_inclusive(line_t, 0.0f, 1.0f);
+        //return all(in_interval_left_inclusive(ts, 0.f, 1.f));
+    };
+
+    fragment.winding_sign = (Sint8)sign(p1.y - p0.y);
+    fragment.out_mask     = intersect_ray(V2f(ray_1, 0.5f), V2f(ray_0, 0.5f));
+    fragment.sample_mask  = intersect_ray(V2f(0.5f,  0.5f), V2f(ray_0, 0.5f));
+}
+
+
+void find_boundary_fragments(
+    const List<Generic_Bezier>& path,
+    const List<Array<Cut, max_cut_count>>& curve_cuts,
+    Range<Uint> curves,
+    List<Boundary_Fragment>& fragments
+) {
+    // Find boundary fragments by rasterizing the curves.
+    for(auto curve_index : curves) {
+        auto& curve = path[curve_index];
+        auto& cuts  = curve_cuts[curve_index];
+
+        // Note: cuts are sorted by t.
+
+        // Skip to first positive cut. (This may skip all cuts.)
+        auto cut_cursor = Uint(0);
+        while(cut_cursor < max_cut_count && cuts[cut_cursor].t <= 0.f + zero_tolerance) {
+            cut_cursor += 1;
+        }
+
+        // Process segments.
+        // cut_p0 is the curve point at cut_t0. it is the end of the previous
+        // fragment and the start of the next one.
+        auto cut_t0 = 0.f;
+        auto cut_p0 = evaluate(curve, cut_t0);
+        while(cut_t0 < 1.f) {
+
+            auto cut_t1 = 1.f;
+            if(cut_cursor < max_cut_count && cuts[cut_cursor].t < 1.f - zero_tolerance) {
+                cut_t1 = cuts[cut_cursor].t;
+                cut_cursor += 1;
+            }
+
+            // Rasterize segment.
+
+            const auto p0 = cut_p0;
+            const auto p1 = evaluate(curve, cut_t1);
+
+            // these are inclusive, hence the first/last nomenclature.
+            const auto first_fragment = V2s(floor(p0));
+            const auto last_fragment  = V2s(floor(p1));
+
+            const auto step = sign(p1 - p0);
+            const auto step_count = abs(last_fragment - first_fragment);
+
+            // each step adds a fragment plus the starting fragment.
+            const auto frag_count = Uint(step_count.x + step_count.y + 1);
+
+
+            auto steps_remaining = step_count;
+            auto fragment_cursor = first_fragment;
+
+            const auto find_next_t = [&](Uint axis) -> Float32 {
+                // the fragment_cursor is always in the bottom right of the fragment.
+                // `fragment_cursor + grid_offset + step` yields the next grid lines.
+                const auto grid_offset = V2f(0.5f) - 0.5f*step;
+
+                auto next_pos = fragment_cursor[axis] + grid_offset[axis] + step[axis];
+
+                // segment is monotonic -> at most one root in segment interval.
+                // root finding may however return roots outside of the segment.
+
+                auto clamp_t = [=](Float32 t) {
+                    if     (t < cut_t0 - zero_tolerance) { return 2.f; }
+                    else if(t > cut_t1 + zero_tolerance) { return 2.f; }
+                    return clamp(t, cut_t0, cut_t1);
+                };
+
+                // TODO: consider negative zero!
+                // early out if there is no root.
+                auto y0 = cut_p0[axis] - next_pos;
+                auto y1 = p1[axis]     - next_pos;
+                if(float_sign(y0) == float_sign(y1)) {
+                    return 2.0f;
+                }
+
+                auto t_min = 2.f;
+
+                switch (curve.degree) {
+                    case 1: {
+                        auto bezier = get_bezier_1(curve);
+                        auto component_bezier = get_component_bezier(bezier, axis);
+                        auto poly = get_poly<Float32>(component_bezier);
+                        poly[0] -= next_pos;
+
+                        auto r0 = 2.f;
+                        find_roots(poly, r0, zero_tolerance);
+                        t_min = clamp_t(r0);
+                    } break;
+
+                    case 2: {
+                        auto bezier = get_bezier_2(curve);
+                        auto component_bezier = get_component_bezier(bezier, axis);
+                        auto poly = get_poly<Float32>(component_bezier);
+                        poly[0] -= next_pos;
+
+                        auto r0 = 2.f, r1 = 2.f;
+                        find_roots(poly, r0, r1, zero_tolerance);
+                        t_min = min(clamp_t(r0), clamp_t(r1));
+                    } break;
+
+                    case 3: {
+                        auto bezier = get_bezier_3(curve);
+                        auto component_bezier = get_component_bezier(bezier, axis);
+                        auto poly = component_bezier;
+                        auto derivative = derive<Float32>(poly);
+                        //auto poly = get_poly<Float32>(component_bezier);
+                        //poly[0] -= next_pos;
+
+                        //auto derivative = derive<Float32>(poly);
+
+                        // Safeguarded Newton.
+                        // the segment is monotone and y0, y1 have different
+                        // signs, so [cut_t0, cut_t1] brackets the only root.
+                        // steps that would leave the bracket bisect instead.
+                        // start at the previous crossing, where the value is
+                        // already known. it's at most a pixel away, so newton
+                        // usually converges in one or two steps.
+                        constexpr Uint max_iter_count = 12;
+                        auto t_lo = cut_t0;
+                        auto t_hi = cut_t1;
+                        auto t = cut_t0;
+                        auto p = y0;
+                        for(auto i : Range<Uint>(max_iter_count)) { UNUSED(i);
+                            if(abs(p) <= crossing_tolerance) {
+                                break;
+                            }
+
+                            auto dp = evaluate_casteljau(derivative, t);
+                            auto next_t = t - p/dp;
+                            if(!(next_t >= t_lo && next_t <= t_hi)) {
+                                next_t = 0.5f*(t_lo + t_hi);
+                            }
+                            if(next_t == t) {
+                                break;
+                            }
+
+                            t = next_t;
+                            p = evaluate_casteljau(poly, t) - next_pos;
+
+                            if(float_sign(p) == float_sign(y0)) { t_lo = t; }
+                            else                                { t_hi = t; }
+                        }
+
+                        t_min = t;
+                    } break;
+
+                    default: throw Exception();
+                }
+
+                if(t_min > 1.f) {
+                    if(t_min <= 1.f + zero_tolerance) {
+                        t_min = 1.f;
+                    }
+                    else {
+                        t_min = 2.f;
+                    }
+                }
+
+                return t_min;
+            };
+
+            auto next_t = V2f(find_next_t(0), find_next_t(1));
+
+            for(auto i : Range<Uint>(frag_count)) {
+                auto min_axis = Uint(next_t[0] < next_t[1] ? 0 : 1);
+                auto step_t   = next_t[min_axis];
+
+                auto fragment = Boundary_Fragment();
+                fragment.key = make_fragment_key(fragment_cursor);
+
+                auto fragment_position = fragment_cursor;
+                auto fragment_p0       = cut_p0;
+
+                if(steps_remaining[min_axis] > 0) {
+                    // take a step.
+                    fragment_cursor[min_axis] += Sint32(step[min_axis]);
+                    steps_remaining[min_axis] -= 1;
+
+                    // advance time, so find_next_t does not give us previous results.
+                    cut_t0 = min(step_t, cut_t1);
+                    cut_p0 = (cut_t0 == cut_t1) ? p1 : evaluate(curve, cut_t0);
+
+                    next_t[min_axis] = find_next_t(min_axis);
+                }
+                else {
+                    next_t[min_axis] = 2.f;
+                }
+
+                // the fragment ends where the next one starts. the last one
+                // ends at the end of the segment.
+                auto fragment_p1 = (i + 1 < frag_count) ? cut_p0 : p1;
+
+                compute_winding(fragment, fragment_position, fragment_p0, fragment_p1);
+                fragments.push_back(fragment);
+            }
+
+            cut_t0 = cut_t1;
+            cut_p0 = p1;
+        }
+    }
+}
+
+List<Boundary_Fragment> find_boundary_fragments(
+    const List<Generic_Bezier>& path,
+    const List<Array<Cut, max_cut_count>>& curve_cuts
+) {
+    auto fragments = List<Boundary_Fragment>();
+    find_boundary_fragments(path, curve_cuts, range_of(path), fragments);
+    return fragments;
+}
+
+
+Uint get_radix_shifts(Uint64 changed, Array<Uint32, 8>& shifts) {
+    auto pass_count = Uint(0);
+    for(auto byte : Range<Uint32>(8)) {
+        if(((changed >> 8*byte) & 0xff) != 0) {
+            shifts[pass_count] = 8*byte;
+            pass_count += 1;
+        }
+    }
+    return pass_count;
+}
+
+void sort_boundary_fragments(List<Boundary_Fragment>& fragments) {
+    constexpr Uint small_count = 64;
+    if(fragments.size() <= small_count) {
+        insertion_sort(make_slice(fragments.data(), fragments.size()),
+            [](const auto& a, const auto& b) { return a.key <= b.key; }
+        );
+        return;
+    }
+
+    auto key_or  = Uint64(0);
+    auto key_and = ~Uint64(0);
+    for(const auto& fragment : fragments) {
+        key_or  |= fragment.key;
+        key_and &= fragment.key;
+    }
+    auto shifts = Array<Uint32, 8>();
+    auto pass_count = get_radix_shifts(key_or ^ key_and, shifts);
+
+    auto counts = Array<Array<Uint32, 256>, 8>();
+    for(auto pass : Range<Uint>(pass_count)) {
+        counts[pass].fill(0);
+    }
+    for(const auto& fragment : fragments) {
+        for(auto pass : Range<Uint>(pass_count)) {
+            counts[pass][(fragment.key >> shifts[pass]) & 0xff] += 1;
+        }
+    }
+
+    auto buffer = List<Boundary_Fragment>(fragments.size());
+    auto source = &fragments;
+    auto dest   = &buffer;
+    for(auto pass : Range<Uint>(pass_count)) {
+        auto shift = shifts[pass];
+
+        auto offsets = Array<Uint32, 256>();
+        auto offset  = Uint32(0);
+        for(auto digit : Range<Uint>(256)) {
+            offsets[digit] = offset;
+            offset += counts[pass][digit];
+        }
+
+        for(const auto& fragment : *source) {
+            auto& at = offsets[(fragment.key >> shift) & 0xff];
+            (*dest)[at] = fragment;
+            at += 1;
+        }
+
+        swap(source, dest);
+    }
+
+    if(source != &fragments) {
+        fragments.swap(buffer);
+    }
+}
+
+List<Boundary_Fragment> sort_boundary_fragments(
+    Thread_Pool& pool,
+    List<List<Boundary_Fragment>>& chunks
+) {
+    auto count = Uint(0);
+    for(const auto& chunk : chunks) {
+        count += chunk.size();
+    }
+
+    auto concatenate = [&]() {
+        auto result = List<Boundary_Fragment>();
+        result.reserve(count);
+        for(const auto& chunk : chunks) {
+            result.insert(result.end(), chunk.begin(), chunk.end());
+        }
+        return result;
+    };
+
+    if(count < parallel_min_fragment_count || pool.thread_count() == 1) {
+        auto result = concatenate();
+        sort_boundary_fragments(result);
+        return result;
+    }
+
+    auto key_ors  = List<Uint64>(chunks.size(), 0);
+    auto key_ands = List<Uint64>(chunks.size(), ~Uint64(0));
+    pool.run(chunks.size(), [&](Uint chunk) {
+        for(const auto& fragment : chunks[chunk]) {
+            key_ors[chunk]  |= fragment.key;
+            key_ands[chunk] &= fragment.key;
+        }
+    });
+
+    auto key_or  = Uint64(0);
+    auto key_and = ~Uint64(0);
+    for(auto chunk : range_of(chunks)) {
+        key_or  |= key_ors[chunk];
+        key_and &= key_ands[chunk];
+    }
+
+    auto shifts = Array<Uint32, 8>();
+    auto pass_count = get_radix_shifts(key_or ^ key_and, shifts);
+    if(pass_count == 0) {
+        return concatenate();
+    }
+
+    // the first pass reads the chunks, the others equal parts of the
+    // previous pass's output.
+    auto sources = List<Slice<Boundary_Fragment>>();
+    for(auto& chunk : chunks) {
+        sources.push_back(make_slice(chunk.data(), chunk.size()));
+    }
+
+    auto buffers = Array<List<Boundary_Fragment>, 2>();
+    buffers[0].resize(count);
+    buffers[1].resize(count);
+
+    auto offsets = List<Array<Uint32, 256>>();
+    for(auto pass : Range<Uint>(pass_count)) {
+        auto shift = shifts[pass];
+        auto& dest = buffers[pass % 2];
+
+        offsets.resize(sources.size());
+        pool.run(sources.size(), [&](Uint slice) {
+            auto& counts = offsets[slice];
+            counts.fill(0);
+            for(const auto& fragment : sources[slice]) {
+                counts[(fragment.key >> shift) & 0xff] += 1;
+            }
+        });
+
+        // by digit, then by slice.
+        auto offset = Uint32(0);
+        for(auto digit : Range<Uint>(256)) {
+            for(auto& slice_offsets : offsets) {
+                auto digit_count = slice_offsets[digit];
+                slice_offsets[digit] = offset;
+                offset += digit_count;
+            }
+        }
+
+        pool.run(sources.size(), [&](Uint slice) {
+            auto& slice_offsets = offsets[slice];
+            for(const auto& fragment : sources[slice]) {
+                auto& at = slice_offsets[(fragment.key >> shift) & 0xff];
+                dest[at] = fragment;
+                at += 1;
+            }
+        });
+
+        auto slice_count = pool.thread_count();
+        sources.clear();
+        for(auto slice : Range<Uint>(slice_count)) {
+            auto range = get_task_range(slice, slice_count, count);
+            sources.push_back(make_slice(dest.data() + range._begin, range.count()));
+        }
+    }
+
+    return std::move(buffers[(pass_count - 1) % 2]);
+}
+
+List<Boundary_Fragment> find_sorted_boundary_fragments(
+    Thread_Pool& pool,
+    const List<Generic_Bezier>& path
+) {
+    auto task_count = min(4*pool.thread_count(), max(path.size()/parallel_min_curve_count, Uint(1)));
+
+    auto curve_cuts = List<Array<Cut, max_cut_count>>(path.size());
+    auto chunks     = List<List<Boundary_Fragment>>(task_count);
+    pool.run(task_count, [&](Uint task) {
+        auto curves = get_task_range(task, task_count, path.size());
+        for(auto curve_index : curves) {
+            curve_cuts[curve_index] = find_monotone_segments(path[curve_index]);
+        }
+        find_boundary_fragments(path, curve_cuts, curves, chunks[task]);
+    });
+
+    return sort_boundary_fragments(pool, chunks);
+}
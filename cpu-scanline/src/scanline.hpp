@@ -0,0 +1,270 @@
+#pragma once
+
+#include <common/common.hpp>
+#include <common/math.hpp>
+#include <common/slice.hpp>
+
+#include <exception>
+using Exception = std::exception;
+
+#include "lina.hpp"
+#include "poly.hpp"
+#include "bezier.hpp"
+#include "thread_pool.hpp"
+
+
+
+struct Generic_Bezier {
+    static constexpr Uint max_point_count = 4;
+
+    Uint32                      degree;
+    Array<V2f, max_point_count> values;
+
+    V2f& operator[](Uint index) {
+        assert(index <= this->degree);
+        return this->values[index];
+    }
+
+    const V2f& operator[](Uint index) const {
+        assert(index <= this->degree);
+        return this->values[index];
+    }
+};
+
+Generic_Bezier generic_line(V2f p0, V2f p1);
+
+Generic_Bezier generic_quadratic(V2f p0, V2f p1, V2f p2);
+
+Generic_Bezier generic_cubic(V2f p0, V2f p1, V2f p2, V2f p3);
+
+
+Bezier<V2f, 0> get_bezier_0(const Generic_Bezier& curve);
+
+Bezier<V2f, 1> get_bezier_1(const Generic_Bezier& curve);
+
+Bezier<V2f, 2> get_bezier_2(const Generic_Bezier& curve);
+
+Bezier<V2f, 3> get_bezier_3(const Generic_Bezier& curve);
+
+
+V2f evaluate_bernstein(const Generic_Bezier& curve, Float32 t);
+
+V2f evaluate_casteljau(const Generic_Bezier& curve, Float32 t);
+
+V2f evaluate(const Generic_Bezier& curve, Float32 t);
+
+
+constexpr Float32 zero_tolerance = 8*FLT_EPSILON;
+
+// max distance of a computed grid line crossing from the grid line, in
+// pixels. zero_tolerance is below float precision for most coordinates.
+constexpr Float32 crossing_tolerance = 1e-3f;
+
+
+
+Uint find_derivative_roots(const Generic_Bezier& curve, Uint32 axis, Float32& t0, Float32& t1);
+
+
+
+void print(const Bezier<V2f, 1>& bezier);
+
+void print(const Bezier<V2f, 2>& bezier);
+
+void print(const Bezier<V2f, 3>& bezier);
+
+void print(const Generic_Bezier& curve);
+
+
+template <typename T, typename F>
+void insertion_sort(Slice<T> slice, F leq) {
+    for(auto i : Range<Uint>(1, slice.count)) {
+        auto j = i;
+        while(j > 0 && !leq(slice[j - 1], slice[j])) {
+            swap(slice[j - 1], slice[j]);
+            j -= 1;
+        }
+    }
+}
+
+
+
+List<Generic_Bezier> compute_stroke(
+    const List<Generic_Bezier>& path, Bool is_closed,
+    Float32 left_offset, Float32 right_offset,
+    Float32 tolerance
+);
+
+
+
+constexpr Uint max_cuts_per_axis = 2;
+constexpr Uint max_cut_count = 2*max_cuts_per_axis;
+struct Cut {
+    Float32 t;
+    Uint32  axis;
+};
+
+// monotone: Ranges where the derivative's sign is constant -> between the roots.
+Array<Cut, max_cut_count> find_monotone_segments(const Generic_Bezier& curve);
+
+
+List<Array<Cut, max_cut_count>> find_monotone_segments(const List<Generic_Bezier>& path);
+
+
+
+// the sort key is y in the high and x in the low 32 bits, with the sign
+// bits flipped, so the keys sort by y then x as unsigned integers.
+inline Uint64 make_fragment_key(V2s position) {
+    auto x = Uint32(position.x) ^ 0x80000000u;
+    auto y = Uint32(position.y) ^ 0x80000000u;
+    return (Uint64(y) << 32) | Uint64(x);
+}
+
+struct Boundary_Fragment {
+    Uint64 key;
+
+    Sint8  winding_sign;
+    Bool   out_mask;     // ((0, 0.5), (1, 0.5)) hits curve?
+    Bool   sample_mask;  // ((0, 0.5), (0.5, 0.5)) hits curve?
+
+    Sint32 x() const { return Sint32(Uint32(this->key) ^ 0x80000000u); }
+    Sint32 y() const { return Sint32(Uint32(this->key >> 32) ^ 0x80000000u); }
+    V2s position() const { return V2s(this->x(), this->y()); }
+};
+
+
+// compute the fragment's winding change and sample mask.
+// p0, p1 are the curve points at the fragment's t0 and t1, treated as exact.
+void compute_winding(Boundary_Fragment& fragment, V2s position, V2f p0, V2f p1);
+
+
+// appends the fragments of the curves in `curves`, in curve order.
+void find_boundary_fragments(
+    const List<Generic_Bezier>& path,
+    const List<Array<Cut, max_cut_count>>& curve_cuts,
+    Range<Uint> curves,
+    List<Boundary_Fragment>& fragments
+);
+
+List<Boundary_Fragment> find_boundary_fragments(
+    const List<Generic_Bezier>& path,
+    const List<Array<Cut, max_cut_count>>& curve_cuts
+);
+
+
+// the shifts of the key bytes that have changed bits.
+Uint get_radix_shifts(Uint64 changed, Array<Uint32, 8>& shifts);
+
+// sort by y then x.
+// lsd radix sort on the key bytes, skipping bytes that are the same for all
+// fragments. paths are usually a few hundred pixels tall and wide, so that's
+// about four passes.
+void sort_boundary_fragments(List<Boundary_Fragment>& fragments);
+
+
+constexpr Uint parallel_min_curve_count    = 64;
+constexpr Uint parallel_min_fragment_count = 16*1024;
+
+// sorts the concatenation of the chunks, like sort_boundary_fragments.
+// each pass counts the digits of a few slices in parallel, then scatters the
+// slices in parallel. the slices are scattered in order, so the sort is
+// stable and gives the same result as the sequential sort.
+List<Boundary_Fragment> sort_boundary_fragments(
+    Thread_Pool& pool,
+    List<List<Boundary_Fragment>>& chunks
+);
+
+// parallel find_boundary_fragments and sort_boundary_fragments. the curves
+// are split into a few ranges per thread, to balance curves of different
+// lengths. the result is the same as the sequential version's.
+List<Boundary_Fragment> find_sorted_boundary_fragments(
+    Thread_Pool& pool,
+    const List<Generic_Bezier>& path
+);
+
+
+extern List<V2s> problem_lines;
+extern Uint current_path;
+
+template <typename On_Span, typename On_Pixel>
+void rasterize(
+    const List<Boundary_Fragment>& fragments,
+    const On_Span& on_span,
+    const On_Pixel& on_pixel
+) {
+    auto scan_winding = Sint32();
+    auto scan_line    = Sint32();
+    auto scan_x       = Sint32();
+
+    auto i = Uint(0);
+    while(i < fragments.size()) {
+        auto key      = fragments[i].key;
+        auto position = fragments[i].position();
+
+        if(position.y != scan_line) {
+            //assert(scan_winding == 0);
+            if(scan_winding != 0) {
+                problem_lines.push_back({scan_x, scan_line});
+                printf("problem: %lld %d %d\n", current_path, scan_x, scan_line);
+            }
+            scan_winding = 0;
+            scan_line = fragments[i].y();
+        }
+        else if(position.x > scan_x && scan_winding != 0) {
+            // Output solid span.
+            auto x0 = scan_x;
+            auto x1 = position.x; // exclusive.
+            auto y  = scan_line;
+            on_span(x0, x1, y);
+        }
+
+
+        // Accumulate winding changes for this pixel.
+        auto delta_out_winding    = Sint32(0);
+        auto delta_sample_winding = Sint32(0);
+        while(i < fragments.size() && fragments[i].key == key) {
+            auto sign = fragments[i].winding_sign;
+            delta_out_winding    += sign*fragments[i].out_mask;
+            delta_sample_winding += sign*fragments[i].sample_mask;
+            i += 1;
+        }
+
+        auto sample_winding = scan_winding + delta_sample_winding;
+        if(sample_winding != 0) {
+            auto x = position.x;
+            auto y = position.y;
+            on_pixel(x, y);
+        }
+
+        scan_winding    += delta_out_winding;
+        scan_x           = position.x + 1;
+    }
+
+    if(scan_winding != 0) {
+        problem_lines.push_back({scan_x, scan_line});
+        printf("problem: %lld %d %d\n", current_path, scan_x, scan_line);
+    }
+}
+
+
+template <typename On_Span, typename On_Pixel>
+void rasterize(
+    const List<Generic_Bezier>& path,
+    const On_Span& on_span,
+    const On_Pixel& on_pixel
+) {
+    auto curve_cuts = find_monotone_segments(path);
+    auto fragments = find_boundary_fragments(path, curve_cuts);
+    sort_boundary_fragments(fragments);
+    rasterize(fragments, on_span, on_pixel);
+}
+
+template <typename On_Span, typename On_Pixel>
+void rasterize(
+    Thread_Pool& pool,
+    const List<Generic_Bezier>& path,
+    const On_Span& on_span,
+    const On_Pixel& on_pixel
+) {
+    auto fragments = find_sorted_boundary_fragments(pool, path);
+    rasterize(fragments, on_span, on_pixel);
+}
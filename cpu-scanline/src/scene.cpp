@@ -0,0 +1,91 @@
+#include "scene.hpp"
+
+#include <emmintrin.h>
+
+
+Bool intersect(const Rect& a, const Rect& b) {
+    return none(a.min >= b.max) && none(b.min >= a.max);
+}
+
+Rect get_union(const Rect& a, const Rect& b) {
+    return Rect {
+        min(a.min, b.min),
+        max(a.max, b.max),
+    };
+}
+
+Rect compute_aabb(const List<Generic_Bezier>& path) {
+    auto result = Rect {
+        V2f(+FLT_MAX, +FLT_MAX),
+        V2f(-FLT_MAX, -FLT_MAX),
+    };
+
+    for(const auto& curve : path) {
+        for(auto i : Range<Uint>(curve.degree + 1)) {
+            result.min = min(result.min, curve[i]);
+            result.max = max(result.max, curve[i]);
+        }
+    }
+
+    return result;
+}
+
+List<Generic_Bezier> compute_stroke(
+    const Path& path,
+    Float32 left_offset, Float32 right_offset,
+    Float32 tolerance
+) {
+    auto result = List<Generic_Bezier>();
+    for(const auto& sub_path : path.sub_paths) {
+        auto curves = List<Generic_Bezier>(
+            path.curves.begin() + Sint(sub_path.begin),
+            path.curves.begin() + Sint(sub_path.end)
+        );
+        auto stroke = compute_stroke(curves, sub_path.closed, left_offset, right_offset, tolerance);
+        result.insert(result.end(), stroke.begin(), stroke.end());
+    }
+    return result;
+}
+
+
+Uint32 to_rgba8(Color c) {
+    const Uint8 bytes[4] = {
+        Uint8(c.r*255.0f), Uint8(c.g*255.0f), Uint8(c.b*255.0f), Uint8(c.a*255.0f),
+    };
+    auto result = Uint32();
+    memcpy(&result, bytes, 4);
+    return result;
+}
+
+void fill_span(
+    Uint8* image, Sint32 width, Sint32 height,
+    Sint32 x0, Sint32 x1, Sint32 y,
+    Uint32 rgba
+) {
+    if(y < 0 || y >= height) {
+        return;
+    }
+
+    x0 = max(x0, 0);
+    x1 = min(x1, width);
+    if(x0 >= x1) {
+        return;
+    }
+
+    auto pixels = image + 4*(Uint(y)*Uint(width) + Uint(x0));
+    auto count  = Uint(x1 - x0);
+
+    auto value = _mm_set1_epi32(Sint32(rgba));
+    auto i = Uint(0);
+    for(; i + 8 <= count; i += 8) {
+        _mm_storeu_si128((__m128i*)(pixels + 4*i),      value);
+        _mm_storeu_si128((__m128i*)(pixels + 4*i + 16), value);
+    }
+    if(i + 4 <= count) {
+        _mm_storeu_si128((__m128i*)(pixels + 4*i), value);
+        i += 4;
+    }
+    for(; i < count; i += 1) {
+        memcpy(pixels + 4*i, &rgba, 4);
+    }
+}
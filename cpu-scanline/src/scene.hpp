@@ -0,0 +1,65 @@
+#pragma once
+
+#include <common/common.hpp>
+#include <common/math.hpp>
+
+#include "lina.hpp"
+#include "scanline.hpp"
+
+
+// a range of the path's curves. closed if it ended with z.
+struct Sub_Path {
+    Uint begin;
+    Uint end;
+    Bool closed;
+};
+
+// curves holds the lines that close open sub-paths for filling too. they
+// are not part of any sub-path, so strokes leave them out.
+struct Path {
+    List<Generic_Bezier> curves;
+    List<Sub_Path> sub_paths;
+};
+
+struct Color {
+    Float32 r, g, b, a;
+};
+
+struct Tiger_Path {
+    Path path;
+    Color fill;
+    Color stroke;
+    Float32 stroke_width;
+};
+
+
+
+struct Rect {
+    V2f min;
+    V2f max;
+};
+
+Bool intersect(const Rect& a, const Rect& b);
+Rect get_union(const Rect& a, const Rect& b);
+Rect compute_aabb(const List<Generic_Bezier>& path);
+
+// strokes each sub-path on its own.
+List<Generic_Bezier> compute_stroke(
+    const Path& path,
+    Float32 left_offset, Float32 right_offset,
+    Float32 tolerance
+);
+
+
+
+// r, g, b, a bytes in memory order.
+Uint32 to_rgba8(Color c);
+
+// fills pixels [x0, x1) of row y of an rgba8 image. clips once, then
+// stores 8 pixels at a time (two 16 byte stores), then 4, then the rest
+// one by one.
+void fill_span(
+    Uint8* image, Sint32 width, Sint32 height,
+    Sint32 x0, Sint32 x1, Sint32 y,
+    Uint32 rgba
+);
@@ -0,0 +1,839 @@
+#include "svg.hpp"
+
+#include <cstdio>
+
+
+constexpr Float64 pi = 3.14159265358979323846;
+
+
+struct Affine {
+    M2f linear;
+    V2f translation;
+};
+
+static Affine identity_affine() {
+    return Affine { M2f(1.0f, 0.0f, 0.0f, 1.0f), V2f(0.0f, 0.0f) };
+}
+
+static V2f apply(const Affine& a, V2f p) {
+    return a.linear*p + a.translation;
+}
+
+static V2f apply(const Affine& a, V2d p) {
+    return apply(a, V2f(p));
+}
+
+// a after b.
+static Affine compose(const Affine& a, const Affine& b) {
+    auto c0 = V2f(b.linear.values[0][0], b.linear.values[1][0]);
+    auto c1 = V2f(b.linear.values[0][1], b.linear.values[1][1]);
+    return Affine {
+        M2f::from_columns(a.linear*c0, a.linear*c1),
+        apply(a, b.translation),
+    };
+}
+
+static Float32 determinant(const M2f& m) {
+    return m.values[0][0]*m.values[1][1] - m.values[0][1]*m.values[1][0];
+}
+
+
+// paint alpha is 0 for none.
+struct Svg_Context {
+    Affine  transform;
+    Color   fill;
+    Color   stroke;
+    Float32 stroke_width;
+    Bool    hidden;
+};
+
+
+
+static Bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static Bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static Bool is_name_char(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || is_digit(c)
+        || c == '_' || c == '-' || c == ':' || c == '.';
+}
+
+static void skip_spaces(const char*& at, const char* end) {
+    while(at < end && is_space(*at)) {
+        at += 1;
+    }
+}
+
+// spaces and commas.
+static void skip_separators(const char*& at, const char* end) {
+    while(at < end && (is_space(*at) || *at == ',')) {
+        at += 1;
+    }
+}
+
+static Bool equals(const char* begin, const char* end, const char* string) {
+    auto length = Uint(end - begin);
+    return strlen(string) == length && memcmp(begin, string, length) == 0;
+}
+
+static Bool starts_with(const char* at, const char* end, const char* string) {
+    auto length = strlen(string);
+    return Uint(end - at) >= length && memcmp(at, string, length) == 0;
+}
+
+// moves `at` past the next occurrence of `string`.
+static Bool skip_past(const char*& at, const char* end, const char* string) {
+    auto length = strlen(string);
+    while(Uint(end - at) >= length) {
+        if(memcmp(at, string, length) == 0) {
+            at += length;
+            return true;
+        }
+        at += 1;
+    }
+    return false;
+}
+
+
+// parses a number like strtof, without the locale.
+// up to 19 significant digits are accumulated in an integer, which is then
+// scaled by a power of ten. the powers up to 1e22 are exact doubles.
+static Bool parse_number(const char*& at, const char* end, Float64& value) {
+    static const Float64 powers_of_ten[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+    };
+
+    auto p = at;
+
+    auto negative = false;
+    if(p < end && (*p == '+' || *p == '-')) {
+        negative = *p == '-';
+        p += 1;
+    }
+
+    auto mantissa    = Uint64(0);
+    auto digit_count = Uint(0);
+    auto exponent    = Sint32(0);
+    auto has_digits  = false;
+
+    while(p < end && is_digit(*p)) {
+        if(digit_count < 19) {
+            mantissa = 10*mantissa + Uint64(*p - '0');
+            digit_count += mantissa != 0;
+        }
+        else {
+            exponent += 1;
+        }
+        has_digits = true;
+        p += 1;
+    }
+
+    if(p < end && *p == '.') {
+        p += 1;
+        while(p < end && is_digit(*p)) {
+            if(digit_count < 19) {
+                mantissa = 10*mantissa + Uint64(*p - '0');
+                digit_count += mantissa != 0;
+                exponent -= 1;
+            }
+            has_digits = true;
+            p += 1;
+        }
+    }
+
+    if(has_digits == false) {
+        return false;
+    }
+
+    // the exponent is optional, "1e" is a 1 followed by something else.
+    if(p < end && (*p == 'e' || *p == 'E')) {
+        auto q = p + 1;
+        auto exponent_negative = false;
+        if(q < end && (*q == '+' || *q == '-')) {
+            exponent_negative = *q == '-';
+            q += 1;
+        }
+        if(q < end && is_digit(*q)) {
+            auto e = Sint32(0);
+            while(q < end && is_digit(*q)) {
+                e = min(10*e + Sint32(*q - '0'), Sint32(1000));
+                q += 1;
+            }
+            exponent += exponent_negative ? -e : e;
+            p = q;
+        }
+    }
+
+    auto result = Float64(mantissa);
+    if(exponent < 0 && exponent >= -22) {
+        result /= powers_of_ten[-exponent];
+    }
+    else if(exponent > 0 && exponent <= 22) {
+        result *= powers_of_ten[exponent];
+    }
+    else if(exponent != 0) {
+        result *= pow(10.0, Float64(exponent));
+    }
+
+    value = negative ? -result : result;
+    at = p;
+    return true;
+}
+
+// path data flags may be written without separators, like "a1,1 0 00.5,1".
+static Bool parse_flag(const char*& at, const char* end, Bool& value) {
+    skip_separators(at, end);
+    if(at < end && (*at == '0' || *at == '1')) {
+        value = *at == '1';
+        at += 1;
+        return true;
+    }
+    return false;
+}
+
+static Bool parse_coordinate(const char*& at, const char* end, Float64& value) {
+    skip_separators(at, end);
+    return parse_number(at, end, value);
+}
+
+static Bool parse_point(const char*& at, const char* end, V2d& value) {
+    return parse_coordinate(at, end, value.x) && parse_coordinate(at, end, value.y);
+}
+
+
+
+// appends cubics approximating the elliptical arc from p0 to p1, as
+// described in the svg spec's implementation notes. each cubic covers at
+// most a quarter of the ellipse.
+template <typename Emit_Cubic>
+static void convert_arc(
+    V2d p0, V2d radii, Float64 angle, Bool large_arc, Bool sweep, V2d p1,
+    const Emit_Cubic& emit_cubic
+) {
+    auto rx = abs(radii.x);
+    auto ry = abs(radii.y);
+
+    auto phi = angle*pi/180.0;
+    auto cos_phi = cos(phi);
+    auto sin_phi = sin(phi);
+
+    // p0 in the ellipse's coordinate system, relative to the chord's middle.
+    auto d  = 0.5*(p0 - p1);
+    auto x1 =  cos_phi*d.x + sin_phi*d.y;
+    auto y1 = -sin_phi*d.x + cos_phi*d.y;
+
+    auto lambda = squared(x1)/squared(rx) + squared(y1)/squared(ry);
+    if(lambda > 1.0) {
+        rx *= sqrt(lambda);
+        ry *= sqrt(lambda);
+    }
+
+    auto numerator   = squared(rx)*squared(ry) - squared(rx)*squared(y1) - squared(ry)*squared(x1);
+    auto denominator = squared(rx)*squared(y1) + squared(ry)*squared(x1);
+    auto coefficient = sqrt(max(numerator, 0.0)/denominator);
+    if(large_arc == sweep) {
+        coefficient = -coefficient;
+    }
+
+    auto cx1 =  coefficient*rx*y1/ry;
+    auto cy1 = -coefficient*ry*x1/rx;
+    auto center = V2d(
+        cos_phi*cx1 - sin_phi*cy1 + 0.5*(p0.x + p1.x),
+        sin_phi*cx1 + cos_phi*cy1 + 0.5*(p0.y + p1.y)
+    );
+
+    auto theta0 = atan2((y1 - cy1)/ry, (x1 - cx1)/rx);
+    auto theta1 = atan2((-y1 - cy1)/ry, (-x1 - cx1)/rx);
+    auto delta  = theta1 - theta0;
+    if(sweep == false && delta > 0.0) { delta -= 2.0*pi; }
+    if(sweep == true  && delta < 0.0) { delta += 2.0*pi; }
+
+    auto map = [&](V2d unit) {
+        auto p = V2d(rx*unit.x, ry*unit.y);
+        return center + V2d(cos_phi*p.x - sin_phi*p.y, sin_phi*p.x + cos_phi*p.y);
+    };
+
+    auto segment_count = max(Uint(ceil(abs(delta)/(0.5*pi) - 1e-3)), Uint(1));
+    auto step = delta/Float64(segment_count);
+    auto k    = 4.0/3.0*tan(step/4.0);
+
+    auto start = p0;
+    for(auto i : Range<Uint>(segment_count)) {
+        auto a0 = theta0 + Float64(i)*step;
+        auto a1 = a0 + step;
+        auto e0 = V2d(cos(a0), sin(a0));
+        auto e1 = V2d(cos(a1), sin(a1));
+        auto c0 = map(e0 + k*V2d(-e0.y, e0.x));
+        auto c1 = map(e1 - k*V2d(-e1.y, e1.x));
+        auto end = (i + 1 == segment_count) ? p1 : map(e1);
+        emit_cubic(start, c0, c1, end);
+        start = end;
+    }
+}
+
+
+// parses path data into curves. the points are transformed as the curves
+// are emitted, bezier curves are invariant under affine maps.
+// sub-paths without z are closed with a line for filling, see Path.
+static Bool parse_path_data(
+    const char* at, const char* end,
+    const Affine& transform,
+    Path& path
+) {
+    auto& curves = path.curves;
+
+    auto emit_line = [&](V2d p0, V2d p1) {
+        curves.push_back(generic_line(apply(transform, p0), apply(transform, p1)));
+    };
+    auto emit_quadratic = [&](V2d p0, V2d p1, V2d p2) {
+        curves.push_back(generic_quadratic(
+            apply(transform, p0), apply(transform, p1), apply(transform, p2)
+        ));
+    };
+    auto emit_cubic = [&](V2d p0, V2d p1, V2d p2, V2d p3) {
+        curves.push_back(generic_cubic(
+            apply(transform, p0), apply(transform, p1), apply(transform, p2), apply(transform, p3)
+        ));
+    };
+
+    auto current = V2d(0.0, 0.0);
+    auto start   = V2d(0.0, 0.0);
+
+    // for the reflected control points of s and t.
+    auto control = V2d(0.0, 0.0);
+    auto previous = char(0);
+
+    auto command = char(0);
+
+    auto sub_path_begin = Uint(0);
+    auto end_sub_path = [&](Bool closed) {
+        if(curves.size() > sub_path_begin) {
+            path.sub_paths.push_back(Sub_Path { sub_path_begin, Uint(curves.size()), closed });
+            if(!closed && !all(current == start)) {
+                emit_line(current, start);
+            }
+        }
+        sub_path_begin = curves.size();
+    };
+
+    while(true) {
+        skip_separators(at, end);
+        if(at == end) {
+            end_sub_path(false);
+            break;
+        }
+
+        auto c = *at;
+        if((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) {
+            command = c;
+            at += 1;
+        }
+        else if(command == 0 || command == 'z' || command == 'Z') {
+            return false;
+        }
+
+        auto relative = command >= 'a' && command <= 'z';
+        auto base     = relative ? current : V2d(0.0, 0.0);
+        auto upper    = char(relative ? command - 'a' + 'A' : command);
+
+        switch(upper) {
+            case 'M': {
+                auto p = V2d();
+                if(!parse_point(at, end, p)) { return false; }
+                end_sub_path(false);
+                current = base + p;
+                start   = current;
+                // following coordinate pairs are line tos.
+                command = relative ? 'l' : 'L';
+            } break;
+
+            case 'L': {
+                auto p = V2d();
+                if(!parse_point(at, end, p)) { return false; }
+                emit_line(current, base + p);
+                current = base + p;
+            } break;
+
+            case 'H': {
+                auto x = Float64();
+                if(!parse_coordinate(at, end, x)) { return false; }
+                auto p = V2d(relative ? current.x + x : x, current.y);
+                emit_line(current, p);
+                current = p;
+            } break;
+
+            case 'V': {
+                auto y = Float64();
+                if(!parse_coordinate(at, end, y)) { return false; }
+                auto p = V2d(current.x, relative ? current.y + y : y);
+                emit_line(current, p);
+                current = p;
+            } break;
+
+            case 'C': {
+                auto p1 = V2d(), p2 = V2d(), p3 = V2d();
+                if(!parse_point(at, end, p1) || !parse_point(at, end, p2) || !parse_point(at, end, p3)) {
+                    return false;
+                }
+                emit_cubic(current, base + p1, base + p2, base + p3);
+                control = base + p2;
+                current = base + p3;
+            } break;
+
+            case 'S': {
+                auto p2 = V2d(), p3 = V2d();
+                if(!parse_point(at, end, p2) || !parse_point(at, end, p3)) {
+                    return false;
+                }
+                auto p1 = (previous == 'C' || previous == 'S') ? 2.0*current - control : current;
+                emit_cubic(current, p1, base + p2, base + p3);
+                control = base + p2;
+                current = base + p3;
+            } break;
+
+            case 'Q': {
+                auto p1 = V2d(), p2 = V2d();
+                if(!parse_point(at, end, p1) || !parse_point(at, end, p2)) {
+                    return false;
+                }
+                emit_quadratic(current, base + p1, base + p2);
+                control = base + p1;
+                current = base + p2;
+            } break;
+
+            case 'T': {
+                auto p2 = V2d();
+                if(!parse_point(at, end, p2)) { return false; }
+                auto p1 = (previous == 'Q' || previous == 'T') ? 2.0*current - control : current;
+                emit_quadratic(current, p1, base + p2);
+                control = p1;
+                current = base + p2;
+            } break;
+
+            case 'A': {
+                auto radii = V2d(), p = V2d();
+                auto angle = Float64();
+                auto large_arc = false, sweep = false;
+                if(!parse_point(at, end, radii) || !parse_coordinate(at, end, angle)
+                || !parse_flag(at, end, large_arc) || !parse_flag(at, end, sweep)
+                || !parse_point(at, end, p)) {
+                    return false;
+                }
+
+                p = base + p;
+                if(all(p == current)) {
+                    // nothing.
+                }
+                else if(radii.x == 0.0 || radii.y == 0.0) {
+                    emit_line(current, p);
+                }
+                else {
+                    convert_arc(current, radii, angle, large_arc, sweep, p, emit_cubic);
+                }
+                current = p;
+            } break;
+
+            case 'Z': {
+                if(!all(current == start)) {
+                    emit_line(current, start);
+                }
+                end_sub_path(true);
+                current = start;
+            } break;
+
+            default: return false;
+        }
+
+        previous = upper;
+    }
+
+    return true;
+}
+
+
+
+static Bool parse_hex_color(const char* begin, const char* end, Color& color) {
+    auto length = Uint(end - begin);
+    if(length != 3 && length != 6) {
+        return false;
+    }
+
+    Uint32 digits[6];
+    for(auto i : Range<Uint>(length)) {
+        auto c = begin[i];
+        if(is_digit(c))             { digits[i] = Uint32(c - '0'); }
+        else if(c >= 'a' && c <= 'f') { digits[i] = Uint32(c - 'a' + 10); }
+        else if(c >= 'A' && c <= 'F') { digits[i] = Uint32(c - 'A' + 10); }
+        else { return false; }
+    }
+
+    Float32 channels[3];
+    for(auto i : Range<Uint>(3)) {
+        channels[i] = (length == 3)
+            ? Float32(17*digits[i])/255.0f
+            : Float32(16*digits[2*i] + digits[2*i + 1])/255.0f;
+    }
+
+    color = Color { channels[0], channels[1], channels[2], 1.0f };
+    return true;
+}
+
+// unsupported paints, like gradients, are none.
+static Color parse_paint(const char* begin, const char* end) {
+    struct Named_Color {
+        const char* name;
+        Color       color;
+    };
+    static const Named_Color named_colors[] = {
+        { "black",  { 0.0f, 0.0f, 0.0f, 1.0f } },
+        { "white",  { 1.0f, 1.0f, 1.0f, 1.0f } },
+        { "red",    { 1.0f, 0.0f, 0.0f, 1.0f } },
+        { "lime",   { 0.0f, 1.0f, 0.0f, 1.0f } },
+        { "green",  { 0.0f, 128.0f/255.0f, 0.0f, 1.0f } },
+        { "blue",   { 0.0f, 0.0f, 1.0f, 1.0f } },
+        { "yellow", { 1.0f, 1.0f, 0.0f, 1.0f } },
+        { "gray",   { 128.0f/255.0f, 128.0f/255.0f, 128.0f/255.0f, 1.0f } },
+        { "grey",   { 128.0f/255.0f, 128.0f/255.0f, 128.0f/255.0f, 1.0f } },
+    };
+
+    auto none = Color { 0.0f, 0.0f, 0.0f, 0.0f };
+
+    if(begin < end && *begin == '#') {
+        auto color = Color();
+        return parse_hex_color(begin + 1, end, color) ? color : none;
+    }
+
+    if(starts_with(begin, end, "rgb(")) {
+        auto at = begin + 4;
+        Float32 channels[3];
+        for(auto& channel : channels) {
+            auto value = Float64();
+            skip_separators(at, end);
+            if(!parse_number(at, end, value)) {
+                return none;
+            }
+            if(at < end && *at == '%') {
+                value = value*255.0/100.0;
+                at += 1;
+            }
+            channel = Float32(clamp(value, 0.0, 255.0)/255.0);
+        }
+        return Color { channels[0], channels[1], channels[2], 1.0f };
+    }
+
+    for(const auto& named : named_colors) {
+        if(equals(begin, end, named.name)) {
+            return named.color;
+        }
+    }
+
+    return none;
+}
+
+static Bool parse_transform(const char* at, const char* end, Affine& transform) {
+    while(true) {
+        skip_separators(at, end);
+        if(at == end) {
+            return true;
+        }
+
+        auto name = at;
+        while(at < end && *at != '(' && !is_space(*at)) {
+            at += 1;
+        }
+        auto name_end = at;
+
+        skip_spaces(at, end);
+        if(at == end || *at != '(') {
+            return false;
+        }
+        at += 1;
+
+        Float32 args[6];
+        auto arg_count = Uint(0);
+        while(true) {
+            skip_separators(at, end);
+            if(at < end && *at == ')') {
+                at += 1;
+                break;
+            }
+            auto arg = Float64();
+            if(arg_count == 6 || !parse_number(at, end, arg)) {
+                return false;
+            }
+            args[arg_count] = Float32(arg);
+            arg_count += 1;
+        }
+
+        auto t = identity_affine();
+        if(equals(name, name_end, "matrix") && arg_count == 6) {
+            t.linear      = M2f(args[0], args[2], args[1], args[3]);
+            t.translation = V2f(args[4], args[5]);
+        }
+        else if(equals(name, name_end, "translate") && (arg_count == 1 || arg_count == 2)) {
+            t.translation = V2f(args[0], arg_count == 2 ? args[1] : 0.0f);
+        }
+        else if(equals(name, name_end, "scale") && (arg_count == 1 || arg_count == 2)) {
+            t.linear = M2f(args[0], 0.0f, 0.0f, arg_count == 2 ? args[1] : args[0]);
+        }
+        else if(equals(name, name_end, "rotate") && (arg_count == 1 || arg_count == 3)) {
+            auto a = Float32(args[0]*pi/180.0);
+            t.linear = M2f(cos(a), -sin(a), sin(a), cos(a));
+            if(arg_count == 3) {
+                // translate(c) rotate(a) translate(-c).
+                auto c = V2f(args[1], args[2]);
+                t.translation = c - t.linear*c;
+            }
+        }
+        else if(equals(name, name_end, "skewX") && arg_count == 1) {
+            t.linear = M2f(1.0f, tan(Float32(args[0]*pi/180.0)), 0.0f, 1.0f);
+        }
+        else if(equals(name, name_end, "skewY") && arg_count == 1) {
+            t.linear = M2f(1.0f, 0.0f, tan(Float32(args[0]*pi/180.0)), 1.0f);
+        }
+        else {
+            return false;
+        }
+
+        transform = compose(transform, t);
+    }
+}
+
+
+// fill, stroke, stroke-width and transform. other attributes are ignored.
+static Bool apply_property(
+    Svg_Context& context,
+    const char* name, const char* name_end,
+    const char* value, const char* value_end
+) {
+    if(equals(name, name_end, "fill")) {
+        context.fill = parse_paint(value, value_end);
+    }
+    else if(equals(name, name_end, "stroke")) {
+        context.stroke = parse_paint(value, value_end);
+    }
+    else if(equals(name, name_end, "stroke-width")) {
+        auto width = Float64();
+        if(parse_number(value, value_end, width)) {
+            context.stroke_width = Float32(width);
+        }
+    }
+    else if(equals(name, name_end, "transform")) {
+        return parse_transform(value, value_end, context.transform);
+    }
+    return true;
+}
+
+// "name: value; name: value".
+static Bool apply_style(Svg_Context& context, const char* at, const char* end) {
+    while(at < end) {
+        skip_spaces(at, end);
+        auto name = at;
+        while(at < end && *at != ':' && *at != ';') {
+            at += 1;
+        }
+        auto name_end = at;
+        while(name_end > name && is_space(name_end[-1])) {
+            name_end -= 1;
+        }
+
+        if(at == end || *at == ';') {
+            at += at < end;
+            continue;
+        }
+        at += 1;
+
+        skip_spaces(at, end);
+        auto value = at;
+        while(at < end && *at != ';') {
+            at += 1;
+        }
+        auto value_end = at;
+        while(value_end > value && is_space(value_end[-1])) {
+            value_end -= 1;
+        }
+        at += at < end;
+
+        if(!apply_property(context, name, name_end, value, value_end)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+
+Bool parse_svg(const char* text, Uint length, List<Tiger_Path>& paths) {
+    static const char* hidden_elements[] = {
+        "defs", "clipPath", "mask", "marker", "pattern", "symbol",
+    };
+
+    auto at  = text;
+    auto end = text + length;
+
+    auto root = Svg_Context();
+    root.transform    = identity_affine();
+    root.fill         = Color { 0.0f, 0.0f, 0.0f, 1.0f };
+    root.stroke       = Color { 0.0f, 0.0f, 0.0f, 0.0f };
+    root.stroke_width = 1.0f;
+    root.hidden       = false;
+
+    auto stack = List<Svg_Context> { root };
+
+    while(true) {
+        at = (const char*)memchr(at, '<', Uint(end - at));
+        if(at == nullptr) {
+            return stack.size() == 1;
+        }
+        at += 1;
+
+        // comments, processing instructions, cdata, doctype.
+        if(starts_with(at, end, "!--")) {
+            if(!skip_past(at, end, "-->")) { return false; }
+            continue;
+        }
+        if(starts_with(at, end, "?")) {
+            if(!skip_past(at, end, "?>")) { return false; }
+            continue;
+        }
+        if(starts_with(at, end, "![CDATA[")) {
+            if(!skip_past(at, end, "]]>")) { return false; }
+            continue;
+        }
+        if(starts_with(at, end, "!")) {
+            if(!skip_past(at, end, ">")) { return false; }
+            continue;
+        }
+
+        if(starts_with(at, end, "/")) {
+            if(!skip_past(at, end, ">") || stack.size() <= 1) { return false; }
+            stack.pop_back();
+            continue;
+        }
+
+
+        auto name = at;
+        while(at < end && is_name_char(*at)) {
+            at += 1;
+        }
+        auto name_end = at;
+
+        // drop the namespace prefix.
+        for(auto p = name; p < name_end; p += 1) {
+            if(*p == ':') { name = p + 1; }
+        }
+
+        auto context = stack.back();
+        for(auto hidden : hidden_elements) {
+            if(equals(name, name_end, hidden)) {
+                context.hidden = true;
+            }
+        }
+
+        auto is_path = equals(name, name_end, "path");
+        auto data     = (const char*)nullptr;
+        auto data_end = (const char*)nullptr;
+        auto self_closing = false;
+
+        while(true) {
+            skip_spaces(at, end);
+            if(at == end) {
+                return false;
+            }
+            if(*at == '>') {
+                at += 1;
+                break;
+            }
+            if(*at == '/') {
+                if(!starts_with(at, end, "/>")) { return false; }
+                at += 2;
+                self_closing = true;
+                break;
+            }
+
+            auto attribute = at;
+            while(at < end && is_name_char(*at)) {
+                at += 1;
+            }
+            auto attribute_end = at;
+            if(attribute == attribute_end) {
+                return false;
+            }
+
+            skip_spaces(at, end);
+            if(at == end || *at != '=') { return false; }
+            at += 1;
+            skip_spaces(at, end);
+            if(at == end || (*at != '"' && *at != '\'')) { return false; }
+
+            auto quote = *at;
+            auto value = at + 1;
+            auto value_end = (const char*)memchr(value, quote, Uint(end - value));
+            if(value_end == nullptr) { return false; }
+            at = value_end + 1;
+
+            if(equals(attribute, attribute_end, "d")) {
+                data     = value;
+                data_end = value_end;
+            }
+            else if(equals(attribute, attribute_end, "style")) {
+                if(!apply_style(context, value, value_end)) { return false; }
+            }
+            else {
+                if(!apply_property(context, attribute, attribute_end, value, value_end)) { return false; }
+            }
+        }
+
+        if(is_path && context.hidden == false && data != nullptr) {
+            auto path = Tiger_Path();
+            if(!parse_path_data(data, data_end, context.transform, path.path)) {
+                return false;
+            }
+
+            const auto& curves = path.path.curves;
+            if(curves.size() > 0) {
+                path.fill         = context.fill;
+                path.stroke       = context.stroke;
+                path.stroke_width = context.stroke_width*sqrt(abs(determinant(context.transform.linear)));
+                paths.push_back(std::move(path));
+            }
+        }
+
+        if(self_closing == false) {
+            stack.push_back(context);
+        }
+    }
+}
+
+Bool load_svg(const char* file_path, List<Tiger_Path>& paths) {
+    auto text = List<char>();
+    if(!read_file(file_path, text)) {
+        return false;
+    }
+    return parse_svg(text.data(), text.size(), paths);
+}
+
+
+Bool read_file(const char* file_path, List<char>& bytes) {
+    auto file = fopen(file_path, "rb");
+    if(file == nullptr) {
+        return false;
+    }
+    defer { fclose(file); };
+
+    if(fseek(file, 0, SEEK_END) != 0) {
+        return false;
+    }
+    auto size = ftell(file);
+    if(size < 0 || fseek(file, 0, SEEK_SET) != 0) {
+        return false;
+    }
+
+    bytes.resize(Uint(size));
+    return fread(bytes.data(), 1, bytes.size(), file) == bytes.size();
+}
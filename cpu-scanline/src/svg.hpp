@@ -0,0 +1,26 @@
+#pragma once
+
+#include <common/common.hpp>
+
+#include "scene.hpp"
+
+
+// parses the paths of an svg document and appends them to `paths`.
+// the document is scanned once, the path data is parsed straight into
+// curves, no dom is built.
+//
+// supported: path elements, the fill, stroke, stroke-width and transform
+// attributes (also in style attributes) inherited through any element,
+// #rgb, #rrggbb, rgb() and a few named colors, all path commands.
+// paths inside defs, clipPath, mask, marker, pattern and symbol are skipped.
+//
+// returns false if the document or some path data is malformed. the paths
+// parsed before the error are kept.
+Bool parse_svg(const char* text, Uint length, List<Tiger_Path>& paths);
+
+// reads the file and parses it with parse_svg.
+Bool load_svg(const char* file_path, List<Tiger_Path>& paths);
+
+
+// reads the whole file into `bytes`.
+Bool read_file(const char* file_path, List<char>& bytes);
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <common/common.hpp>
+#include <common/math.hpp>
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+
+// runs the tasks of one job at a time on worker threads. the calling thread
+// helps, so a pool with one thread runs everything on the caller.
+struct Thread_Pool {
+    List<std::thread> workers;
+
+    std::mutex              mutex;
+    std::condition_variable job_started;
+    std::condition_variable job_finished;
+
+    const std::function<void(Uint)>* job = nullptr;
+    Uint task_count    = 0;
+    Uint next_task     = 0;
+    Uint running_count = 0;
+    Uint generation    = 0;
+    Bool stopping      = false;
+
+
+    explicit Thread_Pool(Uint thread_count) {
+        for(auto i : Range<Uint>(1, max(thread_count, Uint(1)))) {
+            UNUSED(i);
+            this->workers.push_back(std::thread([this]() { this->work(); }));
+        }
+    }
+
+    ~Thread_Pool() {
+        {
+            auto lock = std::unique_lock<std::mutex>(this->mutex);
+            this->stopping = true;
+        }
+        this->job_started.notify_all();
+
+        for(auto& worker : this->workers) {
+            worker.join();
+        }
+    }
+
+    Thread_Pool(const Thread_Pool&) = delete;
+    Thread_Pool& operator=(const Thread_Pool&) = delete;
+
+
+    Uint thread_count() const {
+        return this->workers.size() + 1;
+    }
+
+    // calls f(task) for each task in [0, task_count) and waits for all of
+    // them.
+    void run(Uint task_count, const std::function<void(Uint)>& f) {
+        if(task_count == 0) {
+            return;
+        }
+
+        if(this->workers.size() == 0 || task_count == 1) {
+            for(auto task : Range<Uint>(task_count)) {
+                f(task);
+            }
+            return;
+        }
+
+        auto lock = std::unique_lock<std::mutex>(this->mutex);
+        this->job           = &f;
+        this->task_count    = task_count;
+        this->next_task     = 0;
+        this->running_count = 0;
+        this->generation   += 1;
+        this->job_started.notify_all();
+
+        this->run_tasks(lock);
+
+        this->job_finished.wait(lock, [this]() {
+            return this->next_task == this->task_count && this->running_count == 0;
+        });
+        this->job = nullptr;
+    }
+
+
+    // takes tasks until there are none left. the lock is held between tasks.
+    void run_tasks(std::unique_lock<std::mutex>& lock) {
+        while(this->job != nullptr && this->next_task < this->task_count) {
+            auto task = this->next_task;
+            this->next_task     += 1;
+            this->running_count += 1;
+
+            auto job = this->job;
+            lock.unlock();
+            (*job)(task);
+            lock.lock();
+
+            this->running_count -= 1;
+        }
+
+        if(this->running_count == 0) {
+            this->job_finished.notify_all();
+        }
+    }
+
+    void work() {
+        auto lock = std::unique_lock<std::mutex>(this->mutex);
+        auto seen_generation = this->generation;
+
+        while(true) {
+            this->job_started.wait(lock, [&]() {
+                return this->stopping || this->generation != seen_generation;
+            });
+            if(this->stopping) {
+                return;
+            }
+
+            seen_generation = this->generation;
+            this->run_tasks(lock);
+        }
+    }
+};
+
+
+// splits [0, count) into about task_count equal ranges.
+inline Range<Uint> get_task_range(Uint task, Uint task_count, Uint count) {
+    auto begin = task*count/task_count;
+    auto end   = (task + 1)*count/task_count;
+    return Range<Uint>(begin, end);
+}
@@ -0,0 +1,363 @@
+#include "baked_scene.hpp"
+#include "rasterizer.hpp"
+
+
+namespace raster {
+
+    struct Bounds {
+        V2f  min;
+        V2f  max;
+        Bool is_empty;
+
+        Void include(V2f p) {
+            if(this->is_empty) {
+                this->min      = p;
+                this->max      = p;
+                this->is_empty = false;
+                return;
+            }
+            this->min = V2f({ lpp::min(this->min.x(), p.x()), lpp::min(this->min.y(), p.y()) });
+            this->max = V2f({ lpp::max(this->max.x(), p.x()), lpp::max(this->max.y(), p.y()) });
+        }
+
+        Bool contains(V2f p) const {
+            return p.x() >= this->min.x() && p.x() <= this->max.x()
+                && p.y() >= this->min.y() && p.y() <= this->max.y();
+        }
+    };
+
+    template <Usize degree>
+    Void include_curves(Ref<Bounds> bounds, Ptr<const Bezier<V2f, degree>> curves, U32 count) {
+        for(auto i : Range<U32>(count)) {
+            for(auto j : Range<Usize>(degree + 1)) {
+                bounds.include(curves[i][j]);
+            }
+        }
+    }
+
+    template <Usize degree>
+    Bool are_contained(Ref<const Bounds> bounds, Ptr<const Bezier<V2f, degree>> curves, U32 count) {
+        for(auto i : Range<U32>(count)) {
+            for(auto j : Range<Usize>(degree + 1)) {
+                if(!bounds.contains(curves[i][j])) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+
+    struct Baked_Scene_Layout {
+        U64 paths;
+        U64 paints;
+        U64 segments;
+        U64 curves;
+        U64 size;
+
+        static Baked_Scene_Layout compute(Ref<const Baked_Scene::Header> header) {
+            auto layout = Baked_Scene_Layout();
+            layout.paths    = align_16(sizeof(Baked_Scene::Header));
+            layout.paints   = align_16(layout.paths    + U64(header.path_count)   *sizeof(Baked_Scene::Path));
+            layout.segments = align_16(layout.paints   + U64(header.paint_count)  *sizeof(Baked_Scene::Paint));
+            layout.curves   = align_16(layout.segments + U64(header.segment_count)*sizeof(Segment<V2f>));
+            layout.size     =          layout.curves   + header.curves_size;
+            return layout;
+        }
+    };
+
+
+
+    Baked_Scene_View Baked_Scene_View::from_bytes(Ptr<const Byte> bytes, Usize size) {
+        if(size < sizeof(Baked_Scene::Header)) {
+            throw "Baked scene is truncated.";
+        }
+        // the serialized paths in curves are aligned relative to the start.
+        if(Usize(bytes) % 16 != 0) {
+            throw "Baked scene is misaligned.";
+        }
+
+        const auto& header = *Ptr<const Baked_Scene::Header>(bytes);
+        if(header.magic != Baked_Scene::magic) {
+            throw "Not a baked scene.";
+        }
+        if(header.version != Baked_Scene::version) {
+            throw "Unsupported baked scene version.";
+        }
+
+        // counts are u32, so only curves_size can overflow the layout.
+        if(header.curves_size > U64(size)) {
+            throw "Baked scene is truncated.";
+        }
+        auto layout = Baked_Scene_Layout::compute(header);
+        if(layout.size > U64(size)) {
+            throw "Baked scene is truncated.";
+        }
+
+        auto view = Baked_Scene_View();
+        view.paths             = Ptr<const Baked_Scene::Path> (bytes + layout.paths);
+        view.paints            = Ptr<const Baked_Scene::Paint>(bytes + layout.paints);
+        view.segments          = Ptr<const Segment<V2f>>      (bytes + layout.segments);
+        view.curves            = bytes + layout.curves;
+        view.path_count        = header.path_count;
+        view.paint_count       = header.paint_count;
+        view.segment_count     = header.segment_count;
+        view.flatten_tolerance = header.flatten_tolerance;
+        view.curves_size       = header.curves_size;
+        return view;
+    }
+
+    Void Baked_Scene_View::validate() const {
+        // paints.
+        for(auto i : Range<U32>(this->paint_count)) {
+            auto color = this->paints[i].color;
+            if(    !is_finite(V2f({ color[0], color[1] }))
+                || !is_finite(V2f({ color[2], color[3] }))
+            ) {
+                throw "Baked scene has non-finite colors.";
+            }
+        }
+
+        // segments.
+        if(!is_finite(V2f({ this->flatten_tolerance, 0.0f })) || this->flatten_tolerance < 0.0f) {
+            throw "Baked scene has an invalid flatten tolerance.";
+        }
+        if(!this->has_segments() && this->segment_count != 0) {
+            throw "Baked scene has segments without a flatten tolerance.";
+        }
+        for(auto i : Range<U32>(this->segment_count)) {
+            const auto& segment = this->segments[i];
+            if(!is_finite(segment.p0()) || !is_finite(segment.p1())) {
+                throw "Baked scene has non-finite points.";
+            }
+        }
+
+        // paths.
+        for(auto i : Range<U32>(this->path_count)) {
+            const auto& path = this->paths[i];
+
+            if(path.paint >= this->paint_count) {
+                throw "Baked scene has an invalid paint index.";
+            }
+
+            if(    path.segments_begin > path.segments_end
+                || path.segments_end   > this->segment_count
+            ) {
+                throw "Baked scene has an invalid segment range.";
+            }
+
+            if(    path.curves_offset % 16 != 0
+                || path.curves_offset > this->curves_size
+                || path.curves_size   > this->curves_size - path.curves_offset
+            ) {
+                throw "Baked scene has an invalid curve range.";
+            }
+
+            auto curves = Baked_Path_View();
+            if(path.curves_size > 0) {
+                curves = Baked_Path_View::from_bytes(this->curves + path.curves_offset, Usize(path.curves_size));
+            }
+
+            // culling relies on the bounds.
+            auto bounds = Bounds{ path.bounds_min, path.bounds_max, false };
+            if(!is_finite(bounds.min) || !is_finite(bounds.max)) {
+                throw "Baked scene has non-finite bounds.";
+            }
+            for(auto j : Range<U32>(path.segments_begin, path.segments_end)) {
+                const auto& segment = this->segments[j];
+                if(!bounds.contains(segment.p0()) || !bounds.contains(segment.p1())) {
+                    throw "Baked scene has a path outside of its bounds.";
+                }
+            }
+            if(    !are_contained(bounds, curves.b1s, curves.b1_count)
+                || !are_contained(bounds, curves.b2s, curves.b2_count)
+                || !are_contained(bounds, curves.b3s, curves.b3_count)
+            ) {
+                throw "Baked scene has a path outside of its bounds.";
+            }
+        }
+    }
+
+    Baked_Path_View Baked_Scene_View::get_curves(Ref<const Baked_Scene::Path> path) const {
+        if(path.curves_size == 0) {
+            return Baked_Path_View();
+        }
+        return Baked_Path_View::from_trusted_bytes(this->curves + path.curves_offset, Usize(path.curves_size));
+    }
+
+
+
+    Baked_Scene Baked_Scene::create(F32 flatten_tolerance) {
+        if(!is_finite(V2f({ flatten_tolerance, 0.0f })) || flatten_tolerance < 0.0f) {
+            throw "Invalid flatten tolerance.";
+        }
+
+        auto scene = Baked_Scene();
+        scene.flatten_tolerance = flatten_tolerance;
+        return scene;
+    }
+
+    U32 Baked_Scene::add_paint(V4f color) {
+        this->paints.append_new(Paint{ color });
+        return U32(this->paints.length - 1);
+    }
+
+    Void Baked_Scene::add_path(Ref<const Baked_Path> path, U32 paint) {
+        if(paint >= this->paints.length) {
+            throw "Invalid paint index.";
+        }
+
+        auto result = Path();
+        result.paint    = paint;
+        result.reserved = 0;
+
+        // curves.
+        auto curves_offset = align_16(U64(this->curves.length));
+        auto curves_size   = path.get_serialized_size();
+        this->curves.reserve(Usize(curves_offset) + curves_size);
+        set_bytes(Addr(this->curves.values + this->curves.length), 0, Usize(curves_offset) - this->curves.length);
+        this->curves.length = Usize(curves_offset) + curves_size;
+        path.serialize(this->curves.values + curves_offset);
+
+        result.curves_offset = curves_offset;
+        result.curves_size   = U64(curves_size);
+
+        // segments.
+        result.segments_begin = U32(this->segments.length);
+        if(this->flatten_tolerance > 0.0f) {
+            flatten(path.get_view(), this->flatten_tolerance, this->segments);
+        }
+        result.segments_end = U32(this->segments.length);
+
+        // bounds.
+        // empty paths get empty bounds at the origin.
+        auto bounds = Bounds{ V2f({ 0.0f, 0.0f }), V2f({ 0.0f, 0.0f }), true };
+        include_curves(bounds, path.b1s.get_values(), U32(path.b1s.length));
+        include_curves(bounds, path.b2s.get_values(), U32(path.b2s.length));
+        include_curves(bounds, path.b3s.get_values(), U32(path.b3s.length));
+        for(auto i : Range<U32>(result.segments_begin, result.segments_end)) {
+            bounds.include(this->segments[i].p0());
+            bounds.include(this->segments[i].p1());
+        }
+
+        result.bounds_min = bounds.min;
+        result.bounds_max = bounds.max;
+
+        this->paths.append_new(result);
+    }
+
+
+    Baked_Scene_View Baked_Scene::get_view() const {
+        auto view = Baked_Scene_View();
+        view.paths             = this->paths.get_values();
+        view.paints            = this->paints.get_values();
+        view.segments          = this->segments.get_values();
+        view.curves            = this->curves.get_values();
+        view.path_count        = U32(this->paths.length);
+        view.paint_count       = U32(this->paints.length);
+        view.segment_count     = U32(this->segments.length);
+        view.flatten_tolerance = this->flatten_tolerance;
+        view.curves_size       = U64(this->curves.length);
+        return view;
+    }
+
+    inline Baked_Scene::Header make_header(Ref<const Baked_Scene> scene) {
+        auto header = Baked_Scene::Header();
+        header.magic             = Baked_Scene::magic;
+        header.version           = Baked_Scene::version;
+        header.path_count        = U32(scene.paths.length);
+        header.paint_count       = U32(scene.paints.length);
+        header.segment_count     = U32(scene.segments.length);
+        header.flatten_tolerance = scene.segments.length > 0 ? scene.flatten_tolerance : 0.0f;
+        header.curves_size       = U64(scene.curves.length);
+        return header;
+    }
+
+    Usize Baked_Scene::get_serialized_size() const {
+        return Usize(Baked_Scene_Layout::compute(make_header(*this)).size);
+    }
+
+    Void Baked_Scene::serialize(Ptr<Byte> bytes) const {
+        auto header = make_header(*this);
+        auto layout = Baked_Scene_Layout::compute(header);
+
+        // zero the padding.
+        set_bytes(Addr(bytes), 0, Usize(layout.size));
+
+        copy_bytes(Addr(bytes), Addr(&header), sizeof(header));
+        copy_bytes(Addr(bytes + layout.paths),    Addr(this->paths.values),    this->paths.length   *sizeof(Path));
+        copy_bytes(Addr(bytes + layout.paints),   Addr(this->paints.values),   this->paints.length  *sizeof(Paint));
+        copy_bytes(Addr(bytes + layout.segments), Addr(this->segments.values), this->segments.length*sizeof(Segment<V2f>));
+        copy_bytes(Addr(bytes + layout.curves),   Addr(this->curves.values),   this->curves.length);
+    }
+
+
+    Void Baked_Scene::clear() {
+        this->paths.length    = 0;
+        this->paints.length   = 0;
+        this->segments.length = 0;
+        this->curves.length   = 0;
+    }
+
+    Void Baked_Scene::_destroy() {
+        this->paths._destroy();
+        this->paints._destroy();
+        this->segments._destroy();
+        this->curves._destroy();
+    }
+
+}
+
+namespace raster {
+namespace msaa {
+
+    Void rasterize_path(
+        Ref<Rasterizer> rasterizer,
+        Ref<const Baked_Scene_View> scene,
+        Ref<const Baked_Scene::Path> path,
+        Viewport viewport,
+        F32 tolerance,
+        Ref<List<Segment<V2f>>> segments
+    ) {
+        if(scene.has_segments()) {
+            rasterizer.run(scene.get_segments(path), path.segment_count(), viewport);
+            return;
+        }
+
+        segments.length = 0;
+        flatten(scene.get_curves(path), tolerance, segments);
+        rasterizer.run(segments.get_values(), segments.length, viewport);
+    }
+
+
+    Void render(
+        Ref<Image<Color_Bgra>> image,
+        Ref<const Baked_Scene_View> scene,
+        Ref<const Lut> lut,
+        F32 tolerance
+    ) {
+        auto viewport    = Viewport::from_lengths(image.lengths);
+        auto segments    = List<Segment<V2f>>();
+        auto sample_runs = List<Sample_Run>();
+        auto rasterizer  = Rasterizer(&lut, &sample_runs);
+
+        for(auto i : Range<U32>(scene.path_count)) {
+            const auto& path = scene.paths[i];
+
+            auto color = scene.get_color(path);
+            if(color.a() <= 0.0f || is_outside(path, viewport)) {
+                continue;
+            }
+
+            sample_runs.length = 0;
+            rasterize_path(rasterizer, scene, path, viewport, tolerance, segments);
+
+            composite(image, sample_runs, lut, color);
+        }
+
+        rasterizer._destroy();
+        sample_runs._destroy();
+        segments._destroy();
+    }
+
+}}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "common.hpp"
+#include "msaa.hpp"
+#include "path.hpp"
+
+
+namespace raster {
+
+    struct Baked_Scene_View;
+
+
+    /* Baked_Scene
+        - paths in draw order. each has a paint, bounds, its curves as a
+          serialized baked path and optionally its flattened segments.
+        - create takes the flatten tolerance. add_path flattens when it is
+          > 0. it is the same for all paths and is stored in the header, so
+          it can't change after creation.
+        - bounds hold all control points and segment points, so culling by
+          them is exact for the segments.
+        - serialize writes a header and the 4 arrays, each 16 byte aligned
+          relative to the start of the buffer. the serialized paths in
+          curves are 16 byte aligned too. offsets are relative, so a mapped
+          file only needs its base pointer added.
+    */
+    struct Baked_Scene {
+        static constexpr U32 magic   = 0x454e4353; // "SCNE"
+        static constexpr U32 version = 1;
+
+        struct Header {
+            U32 magic;
+            U32 version;
+            U32 path_count;
+            U32 paint_count;
+            U32 segment_count;
+            F32 flatten_tolerance; // 0: no segments.
+            U64 curves_size;
+        };
+
+        struct Path {
+            U32 paint;
+            U32 segments_begin;
+            U32 segments_end;
+            U32 reserved;
+            U64 curves_offset;
+            U64 curves_size;
+            V2f bounds_min;
+            V2f bounds_max;
+
+            U32 segment_count() const { return this->segments_end - this->segments_begin; }
+        };
+
+        struct Paint {
+            V4f color;
+        };
+
+
+        List<Path>         paths;
+        List<Paint>        paints;
+        List<Segment<V2f>> segments;
+        List<Byte>         curves;
+
+        F32 flatten_tolerance = 0.0f; // set by create.
+
+
+        // flatten_tolerance 0: the scene has no segments.
+        static Baked_Scene create(F32 flatten_tolerance);
+
+        // returns the paint's index.
+        U32 add_paint(V4f color);
+
+        Void add_path(Ref<const Baked_Path> path, U32 paint);
+
+        Baked_Scene_View get_view() const;
+
+        Usize get_serialized_size() const;
+        Void serialize(Ptr<Byte> bytes) const;
+
+        Void clear();
+
+        Void _destroy();
+
+        Baked_Scene() {}
+        LPP_MOVE_IS_DESTROY_CTORS(Baked_Scene, Baked_Scene);
+    };
+
+
+    /* Baked_Scene_View
+        - read only view of a baked scene. does not own the arrays.
+        - from_bytes views a serialized scene in place, e.g. a mapped file.
+          it adds the offsets to the base pointer, nothing is parsed or
+          copied. only the header and the array ranges are checked, so
+          opening a large file doesn't touch its pages.
+        - validate checks all the data, including every path's curves, and
+          throws if it is malformed. call it once for untrusted input, the
+          view can be trusted after.
+    */
+    struct Baked_Scene_View {
+        Ptr<const Baked_Scene::Path>  paths;
+        Ptr<const Baked_Scene::Paint> paints;
+        Ptr<const Segment<V2f>>       segments;
+        Ptr<const Byte>               curves;
+        U32 path_count;
+        U32 paint_count;
+        U32 segment_count;
+        F32 flatten_tolerance;
+        U64 curves_size;
+
+        static Baked_Scene_View from_bytes(Ptr<const Byte> bytes, Usize size);
+
+        Void validate() const;
+
+        Bool has_segments() const { return this->flatten_tolerance > 0.0f; }
+
+        Ptr<const Segment<V2f>> get_segments(Ref<const Baked_Scene::Path> path) const {
+            return this->segments + path.segments_begin;
+        }
+
+        V4f get_color(Ref<const Baked_Scene::Path> path) const {
+            return this->paints[path.paint].color;
+        }
+
+        // the path's curves. has no sub-paths if it has no curves.
+        Baked_Path_View get_curves(Ref<const Baked_Scene::Path> path) const;
+    };
+
+}
+
+namespace raster {
+namespace msaa {
+
+    // true if the path can't cover any pixel of the viewport.
+    inline Bool is_outside(Ref<const Baked_Scene::Path> path, Viewport viewport) {
+        // the filter reaches less than a pixel beyond the segments.
+        return path.bounds_max.x() < F32(viewport.min.x()) - 1.0f
+            || path.bounds_max.y() < F32(viewport.min.y()) - 1.0f
+            || path.bounds_min.x() > F32(viewport.max.x()) + 1.0f
+            || path.bounds_min.y() > F32(viewport.max.y()) + 1.0f;
+    }
+
+    // appends the path's runs to the rasterizer's run list. uses the stored
+    // segments, or flattens the curves into `segments` with tolerance.
+    Void rasterize_path(
+        Ref<Rasterizer> rasterizer,
+        Ref<const Baked_Scene_View> scene,
+        Ref<const Baked_Scene::Path> path,
+        Viewport viewport,
+        F32 tolerance,
+        Ref<List<Segment<V2f>>> segments
+    );
+
+    // composites the paths of the scene in draw order onto image, like
+    // render for Scene. paths whose bounds miss the image are skipped.
+    // scenes without segments are flattened with tolerance.
+    Void render(
+        Ref<Image<Color_Bgra>> image,
+        Ref<const Baked_Scene_View> scene,
+        Ref<const Lut> lut,
+        F32 tolerance
+    );
+
+}}
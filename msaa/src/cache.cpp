@@ -0,0 +1,350 @@
+#include "cache.hpp"
+
+
+namespace raster {
+
+    U64 hash_segments(Ptr<const Segment<V2f>> segments, Usize segment_count) {
+        auto bytes = Ptr<const Byte>(segments);
+        auto size  = segment_count*sizeof(Segment<V2f>);
+
+        auto hash = U64(14695981039346656037ull);
+        for(auto i : Range<Usize>(size)) {
+            hash ^= U64(bytes[i]);
+            hash *= U64(1099511628211ull);
+        }
+        return hash;
+    }
+
+}
+
+namespace raster {
+namespace msaa {
+
+    inline Usize get_memory_size(Ref<const List<Sample_Run>> sample_runs) {
+        return sample_runs.length*sizeof(Sample_Run);
+    }
+
+    // the translation rounded to the nearest phase, in phases. the float
+    // fraction of a translation changes with its integer part, the rounded
+    // one doesn't.
+    inline V2s quantize(V2f translation) {
+        auto n = F32(Run_Key::phase_count);
+        return V2s({
+            floor_to_s32(translation.x()*n + 0.5f),
+            floor_to_s32(translation.y()*n + 0.5f),
+        });
+    }
+
+    inline V2s get_offset(V2f translation) {
+        auto quantized = quantize(translation);
+        auto n = F32(Run_Key::phase_count);
+        return V2s({
+            floor_to_s32(F32(quantized.x())/n),
+            floor_to_s32(F32(quantized.y())/n),
+        });
+    }
+
+
+    // -0 as +0, so equal axes have equal bytes.
+    inline V2f canonical(V2f v) {
+        return V2f({
+            v.x() == 0.0f ? 0.0f : v.x(),
+            v.y() == 0.0f ? 0.0f : v.y(),
+        });
+    }
+
+
+    Run_Key Run_Key::make(U64 path_hash, U32 segment_count, Ref<const Transform> transform) {
+        auto quantized = quantize(transform.translation);
+        auto offset    = get_offset(transform.translation);
+
+        auto key = Run_Key();
+        key.path_hash     = path_hash;
+        key.segment_count = segment_count;
+        key.reserved      = 0;
+        key.x_axis        = canonical(transform.x_axis);
+        key.y_axis        = canonical(transform.y_axis);
+        key.phase_x       = U32(quantized.x() - offset.x()*S32(phase_count));
+        key.phase_y       = U32(quantized.y() - offset.y()*S32(phase_count));
+        return key;
+    }
+
+    U32 Run_Key::hash() const {
+        // fnv-1a over the fields, the struct has no padding.
+        auto bytes = Ptr<const Byte>(this);
+
+        auto hash = U32(2166136261u);
+        for(auto i : Range<Usize>(sizeof(Run_Key))) {
+            hash ^= U32(bytes[i]);
+            hash *= U32(16777619u);
+        }
+        return hash;
+    }
+
+    // the bytes hash reads, so equal keys have equal hashes.
+    Bool Run_Key::equals(Ref<const Run_Key> other) const {
+        return bytes_equal(Addr(this), Addr(&other), sizeof(Run_Key));
+    }
+
+
+
+    Run_Cache Run_Cache::create(Usize memory_budget) {
+        auto cache = Run_Cache();
+        cache.lru_first     = none;
+        cache.lru_last      = none;
+        cache.free_first    = none;
+        cache.memory_budget = memory_budget;
+        cache.memory_used   = 0;
+        cache.hits          = 0;
+        cache.misses        = 0;
+        return cache;
+    }
+
+
+    inline Void unlink(Ref<Run_Cache> cache, U32 index) {
+        auto& entry = cache.entries[index];
+
+        if(entry.prev != Run_Cache::none) { cache.entries[entry.prev].next = entry.next; }
+        else                              { cache.lru_first = entry.next; }
+
+        if(entry.next != Run_Cache::none) { cache.entries[entry.next].prev = entry.prev; }
+        else                              { cache.lru_last = entry.prev; }
+    }
+
+    // as most recently used.
+    inline Void link_last(Ref<Run_Cache> cache, U32 index) {
+        auto& entry = cache.entries[index];
+        entry.prev = cache.lru_last;
+        entry.next = Run_Cache::none;
+
+        if(cache.lru_last != Run_Cache::none) { cache.entries[cache.lru_last].next = index; }
+        else                                  { cache.lru_first = index; }
+        cache.lru_last = index;
+    }
+
+    // the map's values are stored in key order.
+    inline Opt_Ptr<U32> find(Ref<Hash_Map<Run_Key, U32>> map, Ref<const Run_Key> key) {
+        auto key_index = U32(0);
+        if(!map._query(Addr(&key), &key_index)) {
+            return nullptr;
+        }
+        return Ptr<U32>(map.values) + key_index;
+    }
+
+
+    Bool Run_Cache::lookup(U64 path_hash, U32 segment_count, Ref<const Transform> transform, Ref<List<Sample_Run>> sample_runs) {
+        auto key   = Run_Key::make(path_hash, segment_count, transform);
+        auto found = find(this->entry_indices, key);
+        if(found.is_none()) {
+            this->misses += 1;
+            return false;
+        }
+
+        auto index = *found.value;
+        unlink(*this, index);
+        link_last(*this, index);
+
+        const auto& entry = this->entries[index];
+        auto delta = get_offset(transform.translation) - entry.offset;
+
+        sample_runs.reserve(sample_runs.length + entry.sample_runs.length);
+        for(auto run : entry.sample_runs) {
+            run.position = run.position + delta;
+            sample_runs.append_new(run);
+        }
+
+        this->hits += 1;
+        return true;
+    }
+
+    Void Run_Cache::insert(U64 path_hash, U32 segment_count, Ref<const Transform> transform, Ref<const List<Sample_Run>> sample_runs) {
+        auto size = get_memory_size(sample_runs);
+        if(size > this->memory_budget) {
+            return;
+        }
+
+        auto key = Run_Key::make(path_hash, segment_count, transform);
+        if(find(this->entry_indices, key).is_some()) {
+            return;
+        }
+
+        // evict least recently used.
+        while(this->memory_used + size > this->memory_budget) {
+            this->remove(this->lru_first);
+        }
+
+        auto index = this->free_first;
+        if(index != none) {
+            this->free_first = this->entries[index].next;
+        }
+        else {
+            index = U32(this->entries.length);
+            this->entries.append_empty();
+        }
+
+        auto& entry = this->entries[index];
+        entry.key    = key;
+        entry.offset = get_offset(transform.translation);
+
+        new (&entry.sample_runs) List<Sample_Run>();
+        entry.sample_runs.reserve(sample_runs.length);
+        for(const auto& run : sample_runs) {
+            entry.sample_runs.append_new(run);
+        }
+
+        link_last(*this, index);
+        this->entry_indices.insert_maybe(key, index);
+
+        this->memory_used += size;
+    }
+
+    Void Run_Cache::remove(U32 index) {
+        auto& entry = this->entries[index];
+        this->memory_used -= get_memory_size(entry.sample_runs);
+        entry.sample_runs._destroy();
+
+        this->entry_indices.remove_maybe_swap(entry.key);
+        unlink(*this, index);
+
+        entry.next = this->free_first;
+        this->free_first = index;
+    }
+
+    Void Run_Cache::clear() {
+        for(auto index = this->lru_first; index != none; index = this->entries[index].next) {
+            auto& entry = this->entries[index];
+            entry.sample_runs._destroy();
+            this->entry_indices.remove_maybe_swap(entry.key);
+        }
+        this->entries.length = 0;
+        this->lru_first      = none;
+        this->lru_last       = none;
+        this->free_first     = none;
+        this->memory_used    = 0;
+    }
+
+    Void Run_Cache::_destroy() {
+        this->clear();
+        this->entries._destroy();
+        this->entry_indices._destroy();
+        this->segments._destroy();
+        this->sample_runs._destroy();
+    }
+
+
+    Void rasterize_cached(
+        Ref<Run_Cache> cache,
+        U64 path_hash,
+        Ptr<const Segment<V2f>> segments, Usize segment_count,
+        Ref<const Transform> transform,
+        Ref<const Lut> lut,
+        Ref<List<Sample_Run>> sample_runs
+    ) {
+        if(cache.lookup(path_hash, U32(segment_count), transform, sample_runs)) {
+            return;
+        }
+
+        cache.segments.reserve(segment_count);
+        cache.segments.length = 0;
+        for(auto i : Range<Usize>(segment_count)) {
+            cache.segments.append_new(Segment<V2f>({
+                transform.apply(segments[i].p0()),
+                transform.apply(segments[i].p1()),
+            }));
+        }
+
+        cache.sample_runs.length = 0;
+        rasterize(cache.segments, lut, cache.sample_runs);
+
+        cache.insert(path_hash, U32(segment_count), transform, cache.sample_runs);
+
+        sample_runs.reserve(sample_runs.length + cache.sample_runs.length);
+        for(const auto& run : cache.sample_runs) {
+            sample_runs.append_new(run);
+        }
+    }
+
+
+
+    Symbol_Cache Symbol_Cache::create(Ptr<const Lut> lut, U32 phase_count) {
+        assert(phase_count > 0);
+
+        auto cache = Symbol_Cache();
+        cache.lut         = lut;
+        cache.phase_count = phase_count;
+        return cache;
+    }
+
+    U32 Symbol_Cache::add_symbol(Ref<const List<Segment<V2f>>> segments) {
+        auto symbol = Symbol();
+        symbol.segments_begin = U32(this->segments.length);
+
+        this->segments.reserve(this->segments.length + segments.length);
+        for(const auto& segment : segments) {
+            this->segments.append_new(segment);
+        }
+
+        symbol.segments_end = U32(this->segments.length);
+        this->symbols.append_new(symbol);
+
+        for(auto i : Range<U32>(this->phase_count*this->phase_count)) { LPP_UNUSED(i);
+            this->phases.append_new(Phase{ 0, 0, false });
+        }
+
+        return U32(this->symbols.length - 1);
+    }
+
+    Void Symbol_Cache::place(U32 symbol_index, V2f position, Ref<List<Sample_Run>> sample_runs) {
+        auto n = this->phase_count;
+
+        // round to the nearest phase.
+        auto quantized = V2s({
+            floor_to_s32(position.x()*F32(n) + 0.5f),
+            floor_to_s32(position.y()*F32(n) + 0.5f),
+        });
+        auto offset = V2s({
+            floor_to_s32(F32(quantized.x())/F32(n)),
+            floor_to_s32(F32(quantized.y())/F32(n)),
+        });
+        auto phase_x = U32(quantized.x() - offset.x()*S32(n));
+        auto phase_y = U32(quantized.y() - offset.y()*S32(n));
+
+        auto& phase = this->phases[symbol_index*n*n + phase_y*n + phase_x];
+
+        if(!phase.is_ready) {
+            const auto& symbol = this->symbols[symbol_index];
+
+            auto translation = V2f({ F32(phase_x)/F32(n), F32(phase_y)/F32(n) });
+
+            this->translated.length = 0;
+            for(auto i : Range<U32>(symbol.segments_begin, symbol.segments_end)) {
+                const auto& segment = this->segments[i];
+                this->translated.append_new(Segment<V2f>({
+                    segment.p0() + translation,
+                    segment.p1() + translation,
+                }));
+            }
+
+            phase.runs_begin = U32(this->sample_runs.length);
+            rasterize(this->translated, *this->lut, this->sample_runs);
+            phase.runs_end   = U32(this->sample_runs.length);
+            phase.is_ready   = true;
+        }
+
+        sample_runs.reserve(sample_runs.length + (phase.runs_end - phase.runs_begin));
+        for(auto i : Range<U32>(phase.runs_begin, phase.runs_end)) {
+            auto run = this->sample_runs[i];
+            run.position = run.position + offset;
+            sample_runs.append_new(run);
+        }
+    }
+
+    Void Symbol_Cache::_destroy() {
+        this->segments._destroy();
+        this->symbols._destroy();
+        this->phases._destroy();
+        this->sample_runs._destroy();
+        this->translated._destroy();
+    }
+
+}}
@@ -0,0 +1,181 @@
+#pragma once
+
+#include "common.hpp"
+#include "msaa.hpp"
+
+#include <lpp/memory/hash/map.hpp>
+
+
+namespace raster {
+
+    // fnv-1a over the segment bytes.
+    U64 hash_segments(Ptr<const Segment<V2f>> segments, Usize segment_count);
+
+}
+
+namespace raster {
+namespace msaa {
+
+    // the key of a Run_Cache entry. transforms are compared exactly.
+    struct Run_Key {
+        U64 path_hash;
+        U32 segment_count;
+        U32 reserved;
+        V2f x_axis;
+        V2f y_axis;
+        // fractional part of the translation in 1/phase_count pixels.
+        U32 phase_x;
+        U32 phase_y;
+
+        static constexpr U32 phase_count = 256;
+
+        static Run_Key make(U64 path_hash, U32 segment_count, Ref<const Transform> transform);
+
+        U32 hash() const;
+        Bool equals(Ref<const Run_Key> other) const;
+    };
+
+}}
+
+namespace lpp {
+namespace proto {
+
+    LPP_IMPL_PROTO(Hash, , LPP_PASS(raster::msaa::Run_Key, U32), LPP_PASS(
+        [](Addr object, Addr hash_value) {
+            *Ptr<U32>(hash_value) = Ptr<const raster::msaa::Run_Key>(object)->hash();
+        },
+    ));
+
+    LPP_IMPL_PROTO(Equal, , raster::msaa::Run_Key, LPP_PASS(
+        [](Addr a, Addr b) -> Bool {
+            return Ptr<const raster::msaa::Run_Key>(a)->equals(*Ptr<const raster::msaa::Run_Key>(b));
+        },
+    ));
+
+}}
+
+namespace raster {
+namespace msaa {
+
+    /* Run_Cache
+        - retains the sample runs of paths between frames.
+        - entries are keyed by path hash, segment count, the linear part of
+          the transform and the fractional part of the translation, rounded
+          to 1/256 pixel. paths that only moved by whole pixels reuse their
+          runs with an offset.
+        - least recently used entries are evicted to stay within the memory
+          budget (bytes of stored runs). lookups, inserts and evictions are
+          O(1): a hash map finds the entry, and the entries form an intrusive
+          list in order of use.
+        - all lookups must use the same lut.
+    */
+    struct Run_Cache {
+        static constexpr U32 none = U32(-1);
+
+        struct Entry {
+            Run_Key key;
+            V2s offset;
+            // lru list, prev is less recently used. removed entries are
+            // linked through next.
+            U32 prev;
+            U32 next;
+            List<Sample_Run> sample_runs;
+        };
+
+        List<Entry> entries;
+        Hash_Map<Run_Key, U32> entry_indices;
+        U32 lru_first;
+        U32 lru_last;
+        U32 free_first;
+
+        Usize memory_budget;
+        Usize memory_used;
+
+        U64 hits;
+        U64 misses;
+
+        // scratch for misses.
+        List<Segment<V2f>> segments;
+        List<Sample_Run> sample_runs;
+
+
+        static Run_Cache create(Usize memory_budget);
+
+        // appends the cached runs to sample_runs on a hit.
+        Bool lookup(U64 path_hash, U32 segment_count, Ref<const Transform> transform, Ref<List<Sample_Run>> sample_runs);
+
+        Void insert(U64 path_hash, U32 segment_count, Ref<const Transform> transform, Ref<const List<Sample_Run>> sample_runs);
+
+        Void remove(U32 index);
+
+        Void clear();
+
+        Void _destroy();
+
+        Run_Cache() {}
+        LPP_MOVE_IS_DESTROY_CTORS(Run_Cache, Run_Cache);
+    };
+
+
+    // segments are in path space. runs are cached without viewport clipping,
+    // so a hit is valid wherever the path moves.
+    Void rasterize_cached(
+        Ref<Run_Cache> cache,
+        U64 path_hash,
+        Ptr<const Segment<V2f>> segments, Usize segment_count,
+        Ref<const Transform> transform,
+        Ref<const Lut> lut,
+        Ref<List<Sample_Run>> sample_runs
+    );
+
+
+
+    /* Symbol_Cache
+        - for symbols drawn many times at fractional offsets.
+        - instance positions are rounded to 1/phase_count pixels. each symbol
+          is rasterized once per phase (on first use), so an instance is a
+          lookup and a run offset.
+        - the error is at most half a phase step in x and y.
+    */
+    struct Symbol_Cache {
+        static constexpr U32 default_phase_count = 4;
+
+        struct Symbol {
+            U32 segments_begin;
+            U32 segments_end;
+        };
+
+        struct Phase {
+            U32  runs_begin;
+            U32  runs_end;
+            Bool is_ready;
+        };
+
+        Ptr<const Lut> lut;
+        U32 phase_count;
+
+        List<Segment<V2f>> segments;
+        List<Symbol> symbols;
+        // phase_count^2 per symbol.
+        List<Phase> phases;
+        List<Sample_Run> sample_runs;
+
+        // scratch.
+        List<Segment<V2f>> translated;
+
+
+        static Symbol_Cache create(Ptr<const Lut> lut, U32 phase_count = default_phase_count);
+
+        // segments are relative to the symbol's origin. returns the symbol index.
+        U32 add_symbol(Ref<const List<Segment<V2f>>> segments);
+
+        // appends the runs of the symbol with its origin at position.
+        Void place(U32 symbol, V2f position, Ref<List<Sample_Run>> sample_runs);
+
+        Void _destroy();
+
+        Symbol_Cache() {}
+        LPP_MOVE_IS_DESTROY_CTORS(Symbol_Cache, Symbol_Cache);
+    };
+
+}}
@@ -30,28 +30,12 @@ namespace lpp {
 
 namespace raster {
 
-
-    inline U32 _pack(F32x4 color) {
-        auto u8s = pack_with_unsigned_saturation(
-            pack_with_signed_saturation(
-                to_s32s(color)
-            )
-        );
-        return reinterpret_cast<Ref<U32>>(u8s);
-    }
-
-    inline U32 _pack_255(F32x4 color) {
-        return _pack(color * F32x4(255.0f));
-    }
-
-
-    inline F32x4 _unpack(U32 color) {
-        auto u8s = interpret_as_u8s(U32x4(color));
-        return to_f32s(unpack_low(unpack_low(u8s)));
-    }
-
-    inline F32x4 _unpack_255(U32 color) {
-        return _unpack(color) / F32x4(255.0f);
+    F32 Transform::get_max_scale() const {
+        // largest singular value of the linear part.
+        auto a = length_squared(this->x_axis) + length_squared(this->y_axis);
+        auto det = this->x_axis.x()*this->y_axis.y() - this->x_axis.y()*this->y_axis.x();
+        auto d = std::sqrt(max(a*a - 4.0f*det*det, 0.0f));
+        return std::sqrt(0.5f*(a + d));
     }
 
 
@@ -64,6 +64,13 @@ namespace lpp {
         else                  { return T( 0); }
     }
 
+    inline U32 count_ones(U32 value) {
+        value = value - ((value >> 1) & 0x55555555u);
+        value = (value & 0x33333333u) + ((value >> 2) & 0x33333333u);
+        value = (value + (value >> 4)) & 0x0f0f0f0fu;
+        return (value * 0x01010101u) >> 24;
+    }
+
     lpp_def_vector_proc_1_simple(abs)
     lpp_def_vector_proc_1_simple(squared)
     lpp_def_vector_proc_1_simple(sign)
@@ -155,6 +162,52 @@ namespace raster {
     };
 
 
+    // exact comparison.
+    inline Bool equal(V2f a, V2f b) {
+        return a.x() == b.x() && a.y() == b.y();
+    }
+
+    inline Bool is_finite(V2f p) {
+        // inf - inf and nan - nan are nan.
+        return (p.x() - p.x()) == 0.0f && (p.y() - p.y()) == 0.0f;
+    }
+
+    // offsets of serialized arrays.
+    inline U64 align_16(U64 offset) {
+        return (offset + 15) & ~U64(15);
+    }
+
+
+
+    // affine: p.x*x_axis + p.y*y_axis + translation.
+    struct Transform {
+        V2f x_axis;
+        V2f y_axis;
+        V2f translation;
+
+        static Transform identity() {
+            return Transform{ V2f({ 1.0f, 0.0f }), V2f({ 0.0f, 1.0f }), V2f({ 0.0f, 0.0f }) };
+        }
+
+        static Transform translate(V2f translation) {
+            auto result = identity();
+            result.translation = translation;
+            return result;
+        }
+
+        V2f apply(V2f point) const {
+            return point.x()*this->x_axis + point.y()*this->y_axis + this->translation;
+        }
+
+        V2f apply_linear(V2f vector) const {
+            return vector.x()*this->x_axis + vector.y()*this->y_axis;
+        }
+
+        // largest factor by which the transform stretches a length.
+        F32 get_max_scale() const;
+    };
+
+
 
     struct Color_Rgba {
         U32 value;
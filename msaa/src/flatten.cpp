@@ -0,0 +1,383 @@
+#include "flatten.hpp"
+#include "simd/simd.hpp"
+
+#include <cmath>
+
+
+namespace raster {
+
+    F32 get_flatten_precision(F32 tolerance) {
+        return 0.25f*std::sqrt(tolerance);
+    }
+
+    // n = ceil(sqrt(a/precision)), clamped. nan and zero precision give the
+    // max count.
+    inline U32 get_segment_count(F32 a, F32 precision) {
+        auto n = std::ceil(std::sqrt(a/precision));
+        if(!(n <= F32(flatten_max_segment_count))) {
+            return flatten_max_segment_count;
+        }
+        return U32(max(n, 1.0f));
+    }
+
+
+    U32 get_flatten_segment_count(Ref<const Bezier<V2f, 2>> bezier, F32 tolerance) {
+        auto dd = length(bezier[0] - 2.0f*bezier[1] + bezier[2]);
+        if(dd == 0.0f) {
+            return 1;
+        }
+        return get_segment_count(0.25f*dd, get_flatten_precision(tolerance));
+    }
+
+    U32 get_flatten_segment_count(Ref<const Bezier<V2f, 3>> bezier, F32 tolerance) {
+        auto dd0 = length_squared(bezier[0] - 2.0f*bezier[1] + bezier[2]);
+        auto dd1 = length_squared(bezier[1] - 2.0f*bezier[2] + bezier[3]);
+        auto dd  = std::sqrt(max(dd0, dd1));
+        if(dd == 0.0f) {
+            return 1;
+        }
+        return get_segment_count(0.75f*dd, get_flatten_precision(tolerance));
+    }
+
+
+    Void flatten(Ref<const Bezier<V2f, 2>> bezier, F32 tolerance, Ref<List<Segment<V2f>>> segments) {
+        auto n = get_flatten_segment_count(bezier, tolerance);
+
+        // power basis: a t^2 + b t + c.
+        auto a = bezier[0] - 2.0f*bezier[1] + bezier[2];
+        auto b = 2.0f*(bezier[1] - bezier[0]);
+        auto c = bezier[0];
+
+        segments.reserve(segments.length + n);
+
+        auto dt = 1.0f/F32(n);
+        auto p0 = bezier[0];
+        for(auto i : Range<U32>(1, n)) {
+            auto t = F32(i)*dt;
+            auto p1 = (t*a + b)*t + c;
+            segments.append_new(Segment<V2f>({ p0, p1 }));
+            p0 = p1;
+        }
+        segments.append_new(Segment<V2f>({ p0, bezier[2] }));
+    }
+
+    Void flatten(Ref<const Bezier<V2f, 3>> bezier, F32 tolerance, Ref<List<Segment<V2f>>> segments) {
+        auto n = get_flatten_segment_count(bezier, tolerance);
+
+        // power basis: a t^3 + b t^2 + c t + d.
+        auto a = bezier[3] - bezier[0] + 3.0f*(bezier[1] - bezier[2]);
+        auto b = 3.0f*(bezier[0] - 2.0f*bezier[1] + bezier[2]);
+        auto c = 3.0f*(bezier[1] - bezier[0]);
+        auto d = bezier[0];
+
+        segments.reserve(segments.length + n);
+
+        auto dt = 1.0f/F32(n);
+        auto p0 = bezier[0];
+        for(auto i : Range<U32>(1, n)) {
+            auto t = F32(i)*dt;
+            auto p1 = ((t*a + b)*t + c)*t + d;
+            segments.append_new(Segment<V2f>({ p0, p1 }));
+            p0 = p1;
+        }
+        segments.append_new(Segment<V2f>({ p0, bezier[3] }));
+    }
+
+
+    Void simplify_segments(Ref<List<Segment<V2f>>> segments, Usize begin, F32 tolerance) {
+        auto values = segments.get_values();
+
+        auto tolerance_squared = squared(tolerance);
+
+        // interior points of the last output segment.
+        V2f merged[simplify_max_merge_count];
+        auto merged_count = U32(0);
+
+        auto can_merge = [&](Ref<const Segment<V2f>> last, Ref<const Segment<V2f>> next) -> Bool {
+            if(    merged_count >= simplify_max_merge_count
+                || !equal(last.p1(), next.p0())
+                || dot(last.p1() - last.p0(), next.p1() - next.p0()) <= 0.0f
+            ) {
+                return false;
+            }
+
+            auto anchor = last.p0();
+            auto normal = rotated_cw(next.p1() - anchor);
+            auto max_distance_squared = tolerance_squared*length_squared(normal);
+
+            // distance to the merged segment's line, scaled by its length.
+            auto is_near = [&](V2f p) {
+                return squared(dot(p - anchor, normal)) <= max_distance_squared;
+            };
+
+            if(!is_near(last.p1())) {
+                return false;
+            }
+            for(auto i : Range<U32>(merged_count)) {
+                if(!is_near(merged[i])) {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        auto cursor = begin;
+        for(auto i : Range<Usize>(begin, segments.length)) {
+            auto segment = values[i];
+            if(equal(segment.p0(), segment.p1())) {
+                continue;
+            }
+
+            if(cursor > begin) {
+                auto& last = values[cursor - 1];
+                if(can_merge(last, segment)) {
+                    merged[merged_count] = last.p1();
+                    merged_count += 1;
+                    last.p1() = segment.p1();
+                    continue;
+                }
+            }
+
+            values[cursor] = segment;
+            cursor += 1;
+            merged_count = 0;
+        }
+
+        segments.length = cursor;
+    }
+
+
+    Void flatten(Ref<const Bezier<V2f, 2>> bezier, Ref<const Transform> transform, F32 tolerance, Ref<List<Segment<V2f>>> segments) {
+        auto device = Bezier<V2f, 2>({
+            transform.apply(bezier[0]),
+            transform.apply(bezier[1]),
+            transform.apply(bezier[2]),
+        });
+        flatten(device, tolerance, segments);
+    }
+
+    Void flatten(Ref<const Bezier<V2f, 3>> bezier, Ref<const Transform> transform, F32 tolerance, Ref<List<Segment<V2f>>> segments) {
+        auto device = Bezier<V2f, 3>({
+            transform.apply(bezier[0]),
+            transform.apply(bezier[1]),
+            transform.apply(bezier[2]),
+            transform.apply(bezier[3]),
+        });
+        flatten(device, tolerance, segments);
+    }
+
+    F32 get_path_space_tolerance(Ref<const Transform> transform, F32 tolerance) {
+        // the tolerance scales with precision^2.
+        auto scale = transform.get_max_scale();
+        return tolerance / squared(scale);
+    }
+
+
+
+    Void Cubic_Batch::append(Ref<const Bezier<V2f, 3>> bezier) {
+        // pad to a multiple of 4.
+        if(this->length % 4 == 0) {
+            for(auto i : Range<Usize>(4)) {
+                this->xs[i].set_length(this->length + 4);
+                this->ys[i].set_length(this->length + 4);
+                set_bytes(Addr(&this->xs[i][this->length]), 0, 4*sizeof(F32));
+                set_bytes(Addr(&this->ys[i][this->length]), 0, 4*sizeof(F32));
+            }
+        }
+
+        for(auto i : Range<Usize>(4)) {
+            this->xs[i][this->length] = bezier[i].x();
+            this->ys[i][this->length] = bezier[i].y();
+        }
+        this->length += 1;
+    }
+
+    Void Cubic_Batch::clear() {
+        for(auto i : Range<Usize>(4)) {
+            this->xs[i].length = 0;
+            this->ys[i].length = 0;
+        }
+        this->length = 0;
+    }
+
+    Void Cubic_Batch::_destroy() {
+        for(auto i : Range<Usize>(4)) {
+            this->xs[i]._destroy();
+            this->ys[i]._destroy();
+        }
+    }
+
+
+    inline F32x4 load_x4(Ref<const List<F32>> list, Usize index) {
+        return Ptr<F32x4>(Ptr<F32>(list.get_values() + index))->load();
+    }
+
+    Void flatten(Ref<const Cubic_Batch> batch, F32 tolerance, Ref<List<Segment<V2f>>> segments) {
+        auto group_count = (batch.length + 3)/4;
+
+        // segment counts.
+        auto counts = List<U32>();
+        counts.set_length(4*group_count);
+        {
+            auto scale = F32x4(0.75f/get_flatten_precision(tolerance));
+            auto max_count = F32x4(F32(flatten_max_segment_count));
+
+            for(auto group : Range<Usize>(group_count)) {
+                auto base = 4*group;
+
+                auto x0 = load_x4(batch.xs[0], base);
+                auto x1 = load_x4(batch.xs[1], base);
+                auto x2 = load_x4(batch.xs[2], base);
+                auto x3 = load_x4(batch.xs[3], base);
+                auto y0 = load_x4(batch.ys[0], base);
+                auto y1 = load_x4(batch.ys[1], base);
+                auto y2 = load_x4(batch.ys[2], base);
+                auto y3 = load_x4(batch.ys[3], base);
+
+                auto two = F32x4(2.0f);
+                auto ddx0 = x0 - two*x1 + x2;
+                auto ddy0 = y0 - two*y1 + y2;
+                auto ddx1 = x1 - two*x2 + x3;
+                auto ddy1 = y1 - two*y2 + y3;
+                auto dd = sqrt(max(ddx0*ddx0 + ddy0*ddy0, ddx1*ddx1 + ddy1*ddy1));
+
+                // min/max return the second operand for nan.
+                auto n = ceil(sqrt(dd*scale));
+                n = min(n, max_count);
+                n = max(n, F32x4(1.0f));
+
+                Ptr<S32x4>(&counts[base])->store(to_s32s(n));
+            }
+
+            // padding.
+            for(auto i : Range<Usize>(batch.length, 4*group_count)) {
+                counts[i] = 0;
+            }
+        }
+
+        // output offsets.
+        auto offsets = List<U32>();
+        offsets.set_length(4*group_count);
+        auto total = U32(0);
+        for(auto i : Range<Usize>(4*group_count)) {
+            offsets[i] = total;
+            total += counts[i];
+        }
+
+        auto first = segments.length;
+        segments.set_length(first + total);
+        auto out = segments.get_values() + first;
+
+        // forward differencing.
+        for(auto group : Range<Usize>(group_count)) {
+            auto base = 4*group;
+
+            auto x0 = load_x4(batch.xs[0], base);
+            auto x1 = load_x4(batch.xs[1], base);
+            auto x2 = load_x4(batch.xs[2], base);
+            auto x3 = load_x4(batch.xs[3], base);
+            auto y0 = load_x4(batch.ys[0], base);
+            auto y1 = load_x4(batch.ys[1], base);
+            auto y2 = load_x4(batch.ys[2], base);
+            auto y3 = load_x4(batch.ys[3], base);
+
+            auto n = F32x4(
+                F32(counts[base + 0]), F32(counts[base + 1]),
+                F32(counts[base + 2]), F32(counts[base + 3])
+            );
+            auto max_n = max(max(counts[base + 0], counts[base + 1]), max(counts[base + 2], counts[base + 3]));
+            auto min_n = min(min(counts[base + 0], counts[base + 1]), min(counts[base + 2], counts[base + 3]));
+
+            // power basis: a t^3 + b t^2 + c t + d.
+            auto three = F32x4(3.0f);
+            auto ax = x3 - x0 + three*(x1 - x2);
+            auto ay = y3 - y0 + three*(y1 - y2);
+            auto bx = three*(x0 - F32x4(2.0f)*x1 + x2);
+            auto by = three*(y0 - F32x4(2.0f)*y1 + y2);
+            auto cx = three*(x1 - x0);
+            auto cy = three*(y1 - y0);
+
+            // padding lanes have n = 0. their differences are never stored.
+            auto h  = F32x4(1.0f)/max(n, F32x4(1.0f));
+            auto h2 = h*h;
+            auto h3 = h2*h;
+
+            auto six = F32x4(6.0f);
+            auto d1x = ax*h3 + bx*h2 + cx*h;
+            auto d1y = ay*h3 + by*h2 + cy*h;
+            auto d2x = six*ax*h3 + F32x4(2.0f)*bx*h2;
+            auto d2y = six*ay*h3 + F32x4(2.0f)*by*h2;
+            auto d3x = six*ax*h3;
+            auto d3y = six*ay*h3;
+
+            auto px = x0;
+            auto py = y0;
+
+            Ptr<Segment<V2f>> lane_out[4];
+            for(auto lane : Range<Usize>(4)) {
+                lane_out[lane] = out + offsets[base + lane];
+            }
+
+            alignas(16) F32 xs[8];
+            alignas(16) F32 ys[8];
+            _mm_store_ps(xs, px.value);
+            _mm_store_ps(ys, py.value);
+
+            for(auto k : Range<U32>(1, max_n + 1)) {
+                px = px + d1x;
+                py = py + d1y;
+                d1x = d1x + d2x;
+                d1y = d1y + d2y;
+                d2x = d2x + d3x;
+                d2y = d2y + d3y;
+
+                // previous points in 0..3, current in 4..7.
+                auto previous = (k - 1) & 1;
+                auto current  = k & 1;
+                _mm_store_ps(xs + 4*current, px.value);
+                _mm_store_ps(ys + 4*current, py.value);
+
+                if(k < min_n) {
+                    for(auto lane : Range<Usize>(4)) {
+                        lane_out[lane][k - 1] = Segment<V2f>({
+                            V2f({ xs[4*previous + lane], ys[4*previous + lane] }),
+                            V2f({ xs[4*current  + lane], ys[4*current  + lane] }),
+                        });
+                    }
+                    continue;
+                }
+
+                for(auto lane : Range<Usize>(4)) {
+                    auto count = counts[base + lane];
+                    if(k > count) {
+                        continue;
+                    }
+
+                    auto p0 = V2f({ xs[4*previous + lane], ys[4*previous + lane] });
+                    auto p1 = V2f({ xs[4*current  + lane], ys[4*current  + lane] });
+                    if(k == count) {
+                        // exact end point.
+                        p1 = V2f({ batch.xs[3][base + lane], batch.ys[3][base + lane] });
+                    }
+                    lane_out[lane][k - 1] = Segment<V2f>({ p0, p1 });
+                }
+            }
+        }
+
+        counts._destroy();
+        offsets._destroy();
+    }
+
+
+    Void flatten(Ref<const Cubic_Batch> batch, Ref<const Transform> transform, F32 tolerance, Ref<List<Segment<V2f>>> segments) {
+        auto first = segments.length;
+        flatten(batch, get_path_space_tolerance(transform, tolerance), segments);
+
+        for(auto i : Range<Usize>(first, segments.length)) {
+            auto& segment = segments[i];
+            segment.p0() = transform.apply(segment.p0());
+            segment.p1() = transform.apply(segment.p1());
+        }
+    }
+
+}
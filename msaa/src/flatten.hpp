@@ -0,0 +1,139 @@
+#pragma once
+
+#include "common.hpp"
+
+
+namespace raster {
+
+    template <typename Scalar, typename T>
+    Void split(
+        Ref<const Bezier<T, 2>> bezier, Scalar t,
+        Opt_Ptr<Bezier<T, 2>> s0,
+        Opt_Ptr<Bezier<T, 2>> s1
+    ) {
+        auto l00 = bezier[0];
+        auto l01 = bezier[1];
+        auto l02 = bezier[2];
+        auto l10 = lerp(l00, l01, t);
+        auto l11 = lerp(l01, l02, t);
+        auto l20 = lerp(l10, l11, t);
+        if(s0.is_some()) {
+            *s0.value = Bezier<T, 2>({ l00, l10, l20 });
+        }
+        if(s1.is_some()) {
+            *s1.value = Bezier<T, 2>({ l20, l11, l02 });
+        }
+    }
+
+
+    template <typename Scalar, typename T>
+    Void split(
+        Ref<const Bezier<T, 3>> bezier, Scalar t,
+        Opt_Ptr<Bezier<T, 3>> s0,
+        Opt_Ptr<Bezier<T, 3>> s1
+    ) {
+        auto l00 = bezier[0];
+        auto l01 = bezier[1];
+        auto l02 = bezier[2];
+        auto l03 = bezier[3];
+        auto l10 = lerp(l00, l01, t);
+        auto l11 = lerp(l01, l02, t);
+        auto l12 = lerp(l02, l03, t);
+        auto l20 = lerp(l10, l11, t);
+        auto l21 = lerp(l11, l12, t);
+        auto l30 = lerp(l20, l21, t);
+        if(s0.is_some()) {
+            *s0.value = Bezier<T, 3>({ l00, l10, l20, l30 });
+        }
+        if(s1.is_some()) {
+            *s1.value = Bezier<T, 3>({ l30, l21, l12, l03 });
+        }
+    }
+
+
+
+    // precision is the max distance between curve and segments.
+    // the tolerance is 16*precision^2.
+    inline F32 make_flatten_b2_tolerance(F32 precision) {
+        return 16.0f * squared(precision);
+    }
+
+    inline F32 make_flatten_b3_tolerance(F32 precision) {
+        return 16.0f * squared(precision);
+    }
+
+    // inverse of make_flatten_b*_tolerance.
+    F32 get_flatten_precision(F32 tolerance);
+
+
+    /* flatten
+        - uniform subdivision. the segment count is computed up front from
+          the second differences of the control points, so there is no
+          recursion and the output is reserved once.
+        - quadratic: dist <= |p0 - 2 p1 + p2| / (4 n^2).
+        - cubic: dist <= 3 max(|p0 - 2 p1 + p2|, |p1 - 2 p2 + p3|) / (4 n^2).
+        - appends to segments.
+    */
+    constexpr U32 flatten_max_segment_count = 1024;
+
+    U32 get_flatten_segment_count(Ref<const Bezier<V2f, 2>> bezier, F32 tolerance);
+    U32 get_flatten_segment_count(Ref<const Bezier<V2f, 3>> bezier, F32 tolerance);
+
+    Void flatten(Ref<const Bezier<V2f, 2>> bezier, F32 tolerance, Ref<List<Segment<V2f>>> segments);
+    Void flatten(Ref<const Bezier<V2f, 3>> bezier, F32 tolerance, Ref<List<Segment<V2f>>> segments);
+
+    // flattens the transformed curve. the tolerance is in device space, so
+    // transforms that scale down produce proportionally fewer segments.
+    Void flatten(Ref<const Bezier<V2f, 2>> bezier, Ref<const Transform> transform, F32 tolerance, Ref<List<Segment<V2f>>> segments);
+    Void flatten(Ref<const Bezier<V2f, 3>> bezier, Ref<const Transform> transform, F32 tolerance, Ref<List<Segment<V2f>>> segments);
+
+    /* simplify_segments
+        - in place, for segments from index begin on.
+        - removes zero length segments.
+        - merges consecutive connected segments that continue in the same
+          direction, when the skipped points are within tolerance of the
+          merged segment.
+        - horizontal segments are kept. the rasterizer's vertical rays
+          cross them.
+    */
+    constexpr U32 simplify_max_merge_count = 32;
+
+    Void simplify_segments(Ref<List<Segment<V2f>>> segments, Usize begin, F32 tolerance);
+
+
+    // tolerance for flattening in path space, so that the error after the
+    // transform stays within the device space tolerance.
+    F32 get_path_space_tolerance(Ref<const Transform> transform, F32 tolerance);
+
+
+
+    /* Cubic_Batch
+        - cubics in structure of arrays form for batch flattening.
+        - xs[i], ys[i] hold control point i of every curve. the lists are
+          padded to a multiple of 4 curves.
+    */
+    struct Cubic_Batch {
+        List<F32> xs[4];
+        List<F32> ys[4];
+        Usize length = 0;
+
+        Void append(Ref<const Bezier<V2f, 3>> bezier);
+
+        Void clear();
+
+        Void _destroy();
+
+        Cubic_Batch() {}
+        LPP_MOVE_IS_DESTROY_CTORS(Cubic_Batch, Cubic_Batch);
+    };
+
+    // same segments counts as flattening each cubic in order, but evaluates
+    // 4 curves at a time by forward differencing. counts are computed first,
+    // so the output is sized once.
+    Void flatten(Ref<const Cubic_Batch> batch, F32 tolerance, Ref<List<Segment<V2f>>> segments);
+
+    // flattens in path space with get_path_space_tolerance, then transforms
+    // the segments.
+    Void flatten(Ref<const Cubic_Batch> batch, Ref<const Transform> transform, F32 tolerance, Ref<List<Segment<V2f>>> segments);
+
+}
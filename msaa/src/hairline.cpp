@@ -0,0 +1,255 @@
+#include "hairline.hpp"
+#include "flatten.hpp"
+#include "simd/simd.hpp"
+
+#include <algorithm>
+
+
+namespace raster {
+namespace msaa {
+
+    Void Hairline_Rasterizer::rasterize(
+        Ref<const Baked_Path_View> path,
+        F32 width, F32 tolerance,
+        Viewport viewport,
+        Ref<const Lut> lut,
+        Ref<List<Sample_Run>> sample_runs
+    ) {
+        // flatten without closing open sub-paths.
+        this->segments.length = 0;
+        for(auto i : Range<U32>(path.sub_path_count)) {
+            const auto& sub_path = path.sub_paths[i];
+            if(sub_path.indices.length() == 0) {
+                continue;
+            }
+
+            for(auto j : sub_path.indices) {
+                auto index = path.indices[j];
+                switch(index.kind()) {
+                    case Curve_Kind::bezier_1: {
+                        const auto& b1 = path.b1s[index.index()];
+                        this->segments.append_new(Segment<V2f>({ b1[0], b1[1] }));
+                    } break;
+
+                    case Curve_Kind::bezier_2: {
+                        flatten(path.b2s[index.index()], tolerance, this->segments);
+                    } break;
+
+                    case Curve_Kind::bezier_3: {
+                        flatten(path.b3s[index.index()], tolerance, this->segments);
+                    } break;
+                }
+            }
+
+            if(sub_path.is_closed()) {
+                auto first = path.get_first_point(path.indices[sub_path.indices._begin]);
+                auto last  = path.get_last_point(path.indices[sub_path.indices._end - 1]);
+                this->segments.append_new(Segment<V2f>({ last, first }));
+            }
+        }
+
+        this->rasterize(this->segments.get_values(), this->segments.length, width, viewport, lut, sample_runs);
+    }
+
+    Void Hairline_Rasterizer::rasterize(
+        Ptr<const Segment<V2f>> segments, Usize segment_count,
+        F32 width,
+        Viewport viewport,
+        Ref<const Lut> lut,
+        Ref<List<Sample_Run>> sample_runs
+    ) {
+        // padding samples are far away, so they are never set.
+        this->sample_group_count = (U32(lut.sample_count) + 3)/4;
+        for(auto i : Range<U32>(4*this->sample_group_count)) {
+            auto offset = V2f(1e9f);
+            if(i < lut.sample_count) {
+                offset = lut.samples[i]/16.0f + V2f(0.5f);
+            }
+            this->sample_xs[i] = offset.x();
+            this->sample_ys[i] = offset.y();
+        }
+
+        auto half_width = 0.5f*max(width, min_hairline_width);
+
+        this->pixels.length = 0;
+        this->row_begin = s32_max;
+        this->row_end   = s32_min;
+        for(auto i : Range<Usize>(segment_count)) {
+            this->add_segment(segments[i], half_width, viewport);
+        }
+
+        this->sort_pixels();
+
+        // merge pixels touched by several segments, then join equal
+        // neighbors into runs.
+        auto first_run = sample_runs.length;
+
+        const auto& pixels = this->sorted_pixels;
+        auto i = Usize(0);
+        while(i < pixels.length) {
+            auto position    = V2s({ pixels[i].x, pixels[i].y });
+            auto sample_mask = U32(0);
+            while(i < pixels.length && pixels[i].x == position.x() && pixels[i].y == position.y()) {
+                sample_mask |= pixels[i].sample_mask;
+                i += 1;
+            }
+
+            if(sample_runs.length > first_run) {
+                auto& last = sample_runs.last_unchecked();
+                if(    last.position.y() == position.y()
+                    && last.position.x() + S32(last.length) == position.x()
+                    && last.sample_mask == sample_mask
+                ) {
+                    last.length += 1;
+                    continue;
+                }
+            }
+
+            sample_runs.append_new(Sample_Run{ position, 1, sample_mask });
+        }
+    }
+
+    Void Hairline_Rasterizer::add_segment(Ref<const Segment<V2f>> segment, F32 half_width, Viewport viewport) {
+        auto a = segment.p0();
+        auto b = segment.p1();
+        auto d = b - a;
+
+        auto length_squared_ = length_squared(d);
+        auto inv_length_squared = (length_squared_ > 0.0f) ? 1.0f/length_squared_ : 0.0f;
+
+        auto h = half_width;
+
+        auto y_begin = max(floor_to_s32(min(a.y(), b.y()) - h),     viewport.min.y());
+        auto y_end   = min(floor_to_s32(max(a.y(), b.y()) + h) + 1, viewport.max.y());
+
+        auto dx  = F32x4(d.x());
+        auto dy  = F32x4(d.y());
+        auto inv = F32x4(inv_length_squared);
+        auto h2  = F32x4(squared(h));
+        auto zero = F32x4(0.0f);
+        auto one  = F32x4(1.0f);
+
+        for(auto y = y_begin; y < y_end; y += 1) {
+            // part of the segment within half_width of the row.
+            auto t0 = 0.0f;
+            auto t1 = 1.0f;
+            if(d.y() != 0.0f) {
+                auto u0 = (F32(y)     - h - a.y())/d.y();
+                auto u1 = (F32(y + 1) + h - a.y())/d.y();
+                t0 = max(min(u0, u1), 0.0f);
+                t1 = min(max(u0, u1), 1.0f);
+                if(t0 > t1) {
+                    continue;
+                }
+            }
+
+            auto x0 = a.x() + t0*d.x();
+            auto x1 = a.x() + t1*d.x();
+            auto x_begin = max(floor_to_s32(min(x0, x1) - h),     viewport.min.x());
+            auto x_end   = min(floor_to_s32(max(x0, x1) + h) + 1, viewport.max.x());
+
+            auto py = F32x4(F32(y) - a.y());
+
+            for(auto x = x_begin; x < x_end; x += 1) {
+                auto px = F32x4(F32(x) - a.x());
+
+                // distance to the segment per sample.
+                auto sample_mask = U32(0);
+                for(auto group : Range<U32>(this->sample_group_count)) {
+                    auto sx = px + Ptr<F32x4>(&this->sample_xs[4*group])->load();
+                    auto sy = py + Ptr<F32x4>(&this->sample_ys[4*group])->load();
+                    auto t  = min(max((sx*dx + sy*dy)*inv, zero), one);
+                    auto rx = sx - t*dx;
+                    auto ry = sy - t*dy;
+                    auto is_inside = (rx*rx + ry*ry) <= h2;
+                    sample_mask |= is_inside.high_bits_to_mask() << (4*group);
+                }
+
+                if(sample_mask != 0) {
+                    this->pixels.append_new(Pixel{ x, y, sample_mask });
+                }
+            }
+
+            this->row_begin = min(this->row_begin, y);
+            this->row_end   = max(this->row_end,   y + 1);
+        }
+    }
+
+    Void Hairline_Rasterizer::sort_pixels() {
+        auto count = U32(this->pixels.length);
+
+        auto sorted = &this->sorted_pixels;
+        sorted->reserve(count);
+        sorted->length = count;
+        if(count == 0) {
+            return;
+        }
+
+        // counting sort by row.
+        auto row_count = U32(this->row_end - this->row_begin);
+        auto offsets = &this->row_offsets;
+        offsets->reserve(row_count + 1);
+        offsets->length = row_count + 1;
+        set_bytes(Addr(offsets->begin().value), 0, (row_count + 1)*sizeof(U32));
+
+        for(const auto& pixel : this->pixels) {
+            (*offsets)[U32(pixel.y - this->row_begin) + 1] += 1;
+        }
+        for(auto row : Range<U32>(row_count)) {
+            (*offsets)[row + 1] += (*offsets)[row];
+        }
+
+        // offsets[row] is the row's begin after scattering.
+        for(const auto& pixel : this->pixels) {
+            auto& offset = (*offsets)[U32(pixel.y - this->row_begin)];
+            (*sorted)[offset] = pixel;
+            offset += 1;
+        }
+
+        // sort rows by x. segments usually add a row's pixels in order.
+        auto values = sorted->begin().value;
+        auto begin  = U32(0);
+        for(auto row : Range<U32>(row_count)) {
+            auto end = (*offsets)[row];
+
+            auto is_sorted = true;
+            for(auto i : Range<U32>(begin + 1, end)) {
+                if(values[i].x < values[i - 1].x) {
+                    is_sorted = false;
+                    break;
+                }
+            }
+            if(!is_sorted) {
+                std::sort(
+                    values + begin, values + end,
+                    [](const auto& a, const auto& b) {
+                        return a.x < b.x;
+                    }
+                );
+            }
+
+            begin = end;
+        }
+    }
+
+    Void Hairline_Rasterizer::_destroy() {
+        this->segments._destroy();
+        this->pixels._destroy();
+        this->sorted_pixels._destroy();
+        this->row_offsets._destroy();
+    }
+
+
+    Void rasterize_hairline(
+        Ref<const Baked_Path_View> path,
+        F32 width, F32 tolerance,
+        Viewport viewport,
+        Ref<const Lut> lut,
+        Ref<List<Sample_Run>> sample_runs
+    ) {
+        auto rasterizer = Hairline_Rasterizer();
+        rasterizer.rasterize(path, width, tolerance, viewport, lut, sample_runs);
+        rasterizer._destroy();
+    }
+
+}}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "common.hpp"
+#include "msaa.hpp"
+#include "path.hpp"
+
+
+namespace raster {
+namespace msaa {
+
+    /* Hairline_Rasterizer
+        - for strokes about a pixel wide or thinner. skips outline
+          generation and the scanline rasterizer. wider strokes should use
+          the Stroker.
+        - walks each flattened segment row by row over the pixels within
+          half the width, and sets the samples whose distance to the segment
+          is at most half the width. joins and caps are round.
+        - widths below min_hairline_width are widened to it, so the line
+          doesn't break up between samples. scale the color's alpha by
+          get_hairline_alpha to keep the intensity.
+        - the runs are sorted by y, then x, and don't overlap, as produced
+          by the rasterizer.
+        - the lists are scratch space, reused across calls.
+    */
+    // about twice the sample spacing at 16x.
+    constexpr F32 min_hairline_width = 0.5f;
+
+    inline F32 get_hairline_alpha(F32 width) {
+        return min(width/min_hairline_width, 1.0f);
+    }
+
+    struct Hairline_Rasterizer {
+        struct Pixel {
+            S32 x;
+            S32 y;
+            U32 sample_mask;
+        };
+
+        List<Segment<V2f>> segments;
+
+        // pixels are bucketed by row, then sorted by x within rows.
+        List<Pixel> pixels;
+        List<Pixel> sorted_pixels;
+        List<U32>   row_offsets;
+        S32 row_begin;
+        S32 row_end;
+
+        // sample positions relative to the pixel, in groups of 4.
+        alignas(16) F32 sample_xs[Lut::max_sample_count];
+        alignas(16) F32 sample_ys[Lut::max_sample_count];
+        U32 sample_group_count;
+
+
+        Void rasterize(
+            Ref<const Baked_Path_View> path,
+            F32 width, F32 tolerance,
+            Viewport viewport,
+            Ref<const Lut> lut,
+            Ref<List<Sample_Run>> sample_runs
+        );
+
+        Void rasterize(
+            Ptr<const Segment<V2f>> segments, Usize segment_count,
+            F32 width,
+            Viewport viewport,
+            Ref<const Lut> lut,
+            Ref<List<Sample_Run>> sample_runs
+        );
+
+        Void _destroy();
+
+        Hairline_Rasterizer() {}
+        LPP_MOVE_IS_DESTROY_CTORS(Hairline_Rasterizer, Hairline_Rasterizer);
+
+
+        Void add_segment(Ref<const Segment<V2f>> segment, F32 half_width, Viewport viewport);
+        Void sort_pixels();
+    };
+
+    Void rasterize_hairline(
+        Ref<const Baked_Path_View> path,
+        F32 width, F32 tolerance,
+        Viewport viewport,
+        Ref<const Lut> lut,
+        Ref<List<Sample_Run>> sample_runs
+    );
+
+}}
+
@@ -81,248 +81,10 @@ void print(Ref<const Segment<V2f>> segment) {
 }
 
 
-template <typename Scalar, typename T>
-Void split(
-    Ref<const Bezier<T, 2>> bezier, Scalar t,
-    Opt_Ptr<Bezier<T, 2>> s0,
-    Opt_Ptr<Bezier<T, 2>> s1
-) {
-    auto l00 = bezier[0];
-    auto l01 = bezier[1];
-    auto l02 = bezier[2];
-    auto l10 = lerp(l00, l01, t);
-    auto l11 = lerp(l01, l02, t);
-    auto l20 = lerp(l10, l11, t);
-    if(s0.is_some()) {
-        *s0.value = Bezier<T, 2>({ l00, l10, l20 });
-    }
-    if(s1.is_some()) {
-        *s1.value = Bezier<T, 2>({ l20, l11, l02 });
-    }
-}
-
-
-template <typename Scalar, typename T>
-Void split(
-    Ref<const Bezier<T, 3>> bezier, Scalar t,
-    Opt_Ptr<Bezier<T, 3>> s0,
-    Opt_Ptr<Bezier<T, 3>> s1
-) {
-    auto l00 = bezier[0];
-    auto l01 = bezier[1];
-    auto l02 = bezier[2];
-    auto l03 = bezier[3];
-    auto l10 = lerp(l00, l01, t);
-    auto l11 = lerp(l01, l02, t);
-    auto l12 = lerp(l02, l03, t);
-    auto l20 = lerp(l10, l11, t);
-    auto l21 = lerp(l11, l12, t);
-    auto l30 = lerp(l20, l21, t);
-    if(s0.is_some()) {
-        *s0.value = Bezier<T, 3>({ l00, l10, l20, l30 });
-    }
-    if(s1.is_some()) {
-        *s1.value = Bezier<T, 3>({ l30, l21, l12, l03 });
-    }
-}
-
-
-Bool is_flat_enough(Ref<const Bezier<V2f, 2>> bezier, F32 tolerance) {
-    auto err = squared(2.0f*bezier[1] - bezier[0] - bezier[2]);
-    return err.x() + err.y() <= tolerance;
-}
-
-F32 make_flatten_b2_tolerance(F32 precision) {
-    return 16.0f * squared(precision);
-}
-
-
-Bool is_flat_enough(Ref<const Bezier<V2f, 3>> bezier, F32 tolerance) {
-    auto u = squared(3.0f*bezier[1] - 2.0f*bezier[0] - bezier[3]);
-    auto v = squared(3.0f*bezier[2] - 2.0f*bezier[3] - bezier[0]);
-    auto err = V2f(max(u, v));
-    return err.x() + err.y() <= tolerance;
-}
-
-F32 make_flatten_b3_tolerance(F32 precision) {
-    return 16.0f * squared(precision);
-}
-
-
-template <Usize degree>
-Void flatten(Ref<const Bezier<V2f, degree>> bezier, F32 tolerance, Ref<List<Segment<V2f>>> segments) {
-    if(is_flat_enough(bezier, tolerance)) {
-        segments.append_new(Segment<V2f>({ bezier[0], bezier[degree] }));
-    }
-    else {
-        Bezier<V2f, degree> l, r;
-        split<F32, V2f>(bezier, 0.5f, &l, &r);
-        flatten(l, tolerance, segments);
-        flatten(r, tolerance, segments);
-    }
-}
-
-
-
-#if 0
-enum class Curve_Kind {
-    bezier_1 = 1,
-    bezier_2,
-    bezier_3,
-};
-
-struct Baked_Path {
-    struct Curve_Index {
-        static constexpr Usize kind_bit_count = 2;
-
-        Curve_Index(Curve_Kind kind, U32 index)
-            : value(U32(kind) | (index << kind_bit_count)) {}
-
-        Curve_Kind kind() const {
-            return Curve_Kind(value & mask_ending_at<U32>(kind_bit_count));
-        }
-
-        U32 index() const {
-            return value >> kind_bit_count;
-        }
-
-        U32 value;
-    };
-
-    struct Sub_Path {
-        Range<U32> indices;
-        Bool is_closed;
-    };
-
-    List<Bezier<V2f, 1>> b1s;
-    List<Bezier<V2f, 2>> b2s;
-    List<Bezier<V2f, 3>> b3s;
-    List<Curve_Index> indices;
-    List<Sub_Path> sub_paths;
-
-    Path() {}
-    LPP_MOVE_IS_DESTROY_CTORS(Path, Path);
-};
-
-
-struct Path {
-};
-
-
-//constexpr auto zero_tolerance = 8.0f*FLT_EPSILON;
-
-Path compute_stroke(
-    Ref<const Path> path,
-    F32 left_offset, F32 right_offset,
-    F32 tolerance
-) {
-
-    LPP_UNUSED(path, left_offset, right_offset, tolerance);
-
-    /*
-        - turn each sub-path into a new sub-path.
-        - we should really output connected segments though. then you can stroke
-          a stroke. also: Path (with sub-paths and indices) is expected to have
-          consecutive segments. this proc also assumes that. so if we don't want
-          to bother with that, we shouldn't return Path.
-        - so: left outline, cap, right outline (in reverse), cap.
-    */
-
-    // degree reduction.
-    auto quads = List<Bezier<V2f, 2>>();
-    for(const auto& cubic : path.b3s) {
-        LPP_UNUSED(cubic);
-        //reduce_degree(cubic, tolerance, quads);
-    }
-
-    return {};
-
-    #if 0
-
-    // offsetting.
-    auto left_outline  = List<Generic_Bezier>();
-    auto right_outline = List<Generic_Bezier>();
-    for(auto i : range_of(outline)) {
-        const auto& curve = outline[i];
-
-        if(curve.degree == 1) {
-            auto bezier = get_bezier_1(curve);
-            // TODO: zero precision?
-            if(length_squared(bezier[1] - bezier[0]) == 0.0f) {
-                left_outline.push_back(curve);
-                right_outline.push_back(curve);
-            }
-            else {
-                auto n = rotate_ccw(normalized(bezier[1] - bezier[0]));
-                left_outline. push_back(generic_line(bezier[0] + left_offset*n,  bezier[1] + left_offset*n));
-                right_outline.push_back(generic_line(bezier[0] - right_offset*n, bezier[1] - right_offset*n));
-            }
-        }
-        else if(curve.degree == 2) {
-            auto bezier = get_bezier_2(curve);
-            auto l = offset(bezier, +left_offset, zero_tolerance);
-            auto r = offset(bezier, -right_offset, zero_tolerance);
-            left_outline. push_back(generic_quadratic(l[0], l[1], l[2]));
-            right_outline.push_back(generic_quadratic(r[0], r[1], r[2]));
-        }
-        else {
-            assert(false);
-        }
-    }
-
-    // compute stroke by connecting end points.
-    auto stroke = List<Generic_Bezier>();
-    for(auto i : range_of(left_outline)) {
-        const auto& current = left_outline[i];
-
-        if(i > 0) {
-            const auto& prev = left_outline[i - 1];
-            stroke.push_back(generic_line(prev[prev.degree], current[0]));
-        }
-
-        stroke.push_back(current);
-    }
-    for(auto i : range_of(right_outline)) {
-        auto current = right_outline[i];
-
-        if(i > 0) {
-            const auto& prev = right_outline[i - 1];
-            stroke.push_back(generic_line(current[0], prev[prev.degree]));
-        }
-
-        std::reverse(&current.values[0], &current.values[current.degree + 1]);
-        stroke.push_back(current);
-    }
-
-    // Bevel cap.
-    if(is_closed && outline.size() > 1) {
-        const auto& first_left = first(left_outline);
-        const auto& last_left  = last(left_outline);
-        stroke.push_back(generic_line(last_left[last_left.degree], first_left[0]));
-
-        const auto& first_right = first(right_outline);
-        const auto& last_right  = last(right_outline);
-        stroke.push_back(generic_line(first_right[0], last_right[last_right.degree]));
-    }
-    // Bevel join.
-    else {
-        const auto& first_left  = first(left_outline);
-        const auto& first_right = first(right_outline);
-        stroke.push_back(generic_line(first_right[0], first_left[0]));
-
-        const auto& last_left  = last(left_outline);
-        const auto& last_right = last(right_outline);
-        stroke.push_back(generic_line(last_left[last_left.degree], last_right[last_right.degree]));
-    }
-
-    return stroke;
-    #endif
-}
-#endif
-
-
 #include "rasterizer.hpp"
 #include "msaa.hpp"
+#include "flatten.hpp"
+#include "path.hpp"
 
 
 #include <chrono>
@@ -332,39 +94,24 @@ int main() {
 
     constexpr auto precision = 0.141f; // sqrt(1/(16*pi))
 
-    auto my_b1s = List<Bezier<V2f, 1>>();
-    auto my_b3s = List<Bezier<V2f, 3>>();
-    my_b3s.append_new(Bezier<V2f, 3>({ V2f({125, 325}), V2f({150, 425}), V2f({300, 400}), V2f({300, 300}) }));
-    my_b3s.append_new(Bezier<V2f, 3>({V2f({300, 300}), V2f({300, 200}), V2f({150, 175}), V2f({125, 275})}));
-    my_b3s.append_new(Bezier<V2f, 3>({V2f({125, 275}), V2f({125, 225}), V2f({150, 125}), V2f({225, 125})}));
-    my_b1s.append_new(Bezier<V2f, 1>({V2f({225, 125}), V2f({475, 125})}));
-    my_b3s.append_new(Bezier<V2f, 3>({V2f({475, 125}), V2f({400, 200}), V2f({450, 275}), V2f({375, 300})}));
-    my_b3s.append_new(Bezier<V2f, 3>({V2f({375, 300}), V2f({450, 325}), V2f({475, 351.2f}), V2f({475, 400})}));
-    my_b3s.append_new(Bezier<V2f, 3>({V2f({475, 400}), V2f({475, 450}), V2f({450, 475}), V2f({400, 475})}));
-    my_b1s.append_new(Bezier<V2f, 1>({V2f({400, 475}), V2f({225, 475})}));
-    my_b3s.append_new(Bezier<V2f, 3>({V2f({225, 475}), V2f({150, 475}), V2f({125, 375}), V2f({125, 325})}));
+    auto path = Baked_Path();
+    path.move_to(V2f({125, 325}));
+    path.cubic_to(V2f({150, 425}), V2f({300, 400}), V2f({300, 300}));
+    path.cubic_to(V2f({300, 200}), V2f({150, 175}), V2f({125, 275}));
+    path.cubic_to(V2f({125, 225}), V2f({150, 125}), V2f({225, 125}));
+    path.line_to(V2f({475, 125}));
+    path.cubic_to(V2f({400, 200}), V2f({450, 275}), V2f({375, 300}));
+    path.cubic_to(V2f({450, 325}), V2f({475, 351.2f}), V2f({475, 400}));
+    path.cubic_to(V2f({475, 450}), V2f({450, 475}), V2f({400, 475}));
+    path.line_to(V2f({225, 475}));
+    path.cubic_to(V2f({150, 475}), V2f({125, 375}), V2f({125, 325}));
+    path.close();
 
     auto segments = List<Segment<V2f>>();
     segments.reserve(2048);
 
-    #if 1
-    flatten(my_b3s[0], make_flatten_b3_tolerance(precision), segments);
-    flatten(my_b3s[1], make_flatten_b3_tolerance(precision), segments);
-    flatten(my_b3s[2], make_flatten_b3_tolerance(precision), segments);
-    segments.append_new(my_b1s[0]);
-    flatten(my_b3s[3], make_flatten_b3_tolerance(precision), segments);
-    flatten(my_b3s[4], make_flatten_b3_tolerance(precision), segments);
-    flatten(my_b3s[5], make_flatten_b3_tolerance(precision), segments);
-    segments.append_new(my_b1s[1]);
-    flatten(my_b3s[6], make_flatten_b3_tolerance(precision), segments);
-    #else
-    for(const auto& b1 : my_b1s) {
-        segments.append_new(b1);
-    }
-    for(const auto& b3 : my_b3s) {
-        flatten(b3, make_flatten_b3_tolerance(precision), segments);
-    }
-    #endif
+    flatten(path.get_view(), make_flatten_b3_tolerance(precision), segments);
+    simplify_segments(segments, 0, 0.01f);
 
     if(0)
     for(auto& segment : segments) {
@@ -418,6 +165,12 @@ int main() {
         msaa::resolve(image, image_msaa, true);
 
         stbi_write_png("out.png", int(width), int(height), 4, image.samples, int(width)*4);
+
+        auto mask = Image<U8>::create(width, height, 1);
+        set_bytes(Addr(mask.samples), 0, width*height);
+        msaa::rasterize_coverage(segments, lut, mask);
+
+        stbi_write_png("mask.png", int(width), int(height), 1, mask.samples, int(width));
     }
 
     if(1) return 0;
@@ -74,6 +74,10 @@ namespace msaa {
 
         lut.sample_mask = mask_ending_at<U32>(sample_count);
 
+        for(auto i : Range<Usize>(sample_count + 1u)) {
+            lut.coverage[i] = U8((i*255u + sample_count/2u) / sample_count);
+        }
+
         for(auto y : Range<Usize>(resolution)) {
             for(auto x : Range<Usize>(resolution)) {
                 auto tex_coord = (V2f({F32(x), F32(y)}) + V2f(0.5f)) / F32(resolution);
@@ -149,13 +153,91 @@ namespace msaa {
         Ref<const List<Segment<V2f>>> segments,
         Ref<const Lut> lut,
         Ref<List<Sample_Run>> sample_runs
+    ) {
+        rasterize(segments.get_values(), segments.length, lut, sample_runs);
+    }
+
+    Void rasterize(
+        Ptr<const Segment<V2f>> segments, Usize segment_count,
+        Ref<const Lut> lut,
+        Ref<List<Sample_Run>> sample_runs
     ) {
         auto rasterizer = Rasterizer(&lut, &sample_runs);
-        rasterizer.run(segments);
+        rasterizer.run(segments, segment_count);
+        rasterizer._destroy();
+    }
+
+    Void rasterize(
+        Ptr<const Segment<V2f>> segments, Usize segment_count,
+        Viewport viewport,
+        Ref<const Lut> lut,
+        Ref<List<Sample_Run>> sample_runs
+    ) {
+        auto rasterizer = Rasterizer(&lut, &sample_runs);
+        rasterizer.run(segments, segment_count, viewport);
+        rasterizer._destroy();
+    }
+
+
+    Void rasterize_coverage(
+        Ref<const List<Segment<V2f>>> segments,
+        Ref<const Lut> lut,
+        Ref<Image<U8>> mask
+    ) {
+        auto rasterizer = Coverage_Rasterizer(&lut, &mask);
+        rasterizer.run(segments.get_values(), segments.length, Viewport::from_lengths(mask.lengths));
         rasterizer._destroy();
     }
 
 
+    Void clip(
+        Ref<const List<Sample_Run>> content,
+        Ref<const List<Sample_Run>> clip,
+        Ref<List<Sample_Run>> result
+    ) {
+        auto i = Usize(0);
+        auto j = Usize(0);
+
+        while(i < content.length && j < clip.length) {
+            const auto& a = content[i];
+            const auto& b = clip[j];
+
+            // skip scanlines that are not in both lists.
+            if(a.position.y() < b.position.y()) {
+                i += 1;
+                continue;
+            }
+            if(b.position.y() < a.position.y()) {
+                j += 1;
+                continue;
+            }
+
+            auto a_end = a.position.x() + S32(a.length);
+            auto b_end = b.position.x() + S32(b.length);
+
+            auto begin = max(a.position.x(), b.position.x());
+            auto end   = min(a_end, b_end);
+            auto sample_mask = a.sample_mask & b.sample_mask;
+
+            if(begin < end && sample_mask != 0) {
+                result.append_new(Sample_Run{
+                    V2s({ begin, a.position.y() }),
+                    U32(end - begin),
+                    sample_mask,
+                });
+            }
+
+            // advance the run that ends first.
+            if(a_end <= b_end) {
+                i += 1;
+            }
+            else {
+                j += 1;
+            }
+        }
+    }
+
+
     void Rasterizer::on_init() {
         this->normals.reserve(this->infos.length);
         this->normals.length = 0;
@@ -169,8 +251,9 @@ namespace msaa {
     }
 
     void Rasterizer::on_scanline() {
+        // segments right of the viewport are clipped away.
         #if LPP_DEBUG
-        assert(this->scan_winding == 0);
+        assert(this->scan_winding == 0 || this->has_viewport);
         #endif
         this->scan_winding = 0;
     }
@@ -322,6 +405,15 @@ namespace msaa {
                 this->add_sample_run(frag_pos_s32, length, U32(-1));
             }
         }
+        else if(this->has_viewport && this->scan_winding != 0) {
+            // span up to the viewport edge. the segments that would have
+            // ended it were clipped away.
+            auto x_end = this->viewport.max.x();
+            if(this->fragment_begin() < x_end) {
+                auto length = U32(x_end - this->fragment_begin());
+                this->add_sample_run(frag_pos_s32, length, U32(-1));
+            }
+        }
     }
 
     Void Rasterizer::_destroy() {
@@ -350,6 +442,34 @@ namespace msaa {
     }
 
 
+    inline Void write_coverage(Ref<Image<U8>> mask, Ref<const Lut> lut, Sample_Run run) {
+        auto x_begin = U32(clamp(run.position.x(),                   0, S32(mask.lengths.x())));
+        auto x_end   = U32(clamp(run.position.x() + S32(run.length), 0, S32(mask.lengths.x())));
+        auto length = x_end - x_begin;
+
+        if(    length == 0
+            || run.position.y() < 0
+            || U32(run.position.y()) >= mask.lengths.y()
+        ) {
+            return;
+        }
+
+        auto begin = mask.get_first_sample(x_begin, U32(run.position.y()));
+        auto alpha = lut.coverage[count_ones(run.sample_mask & lut.sample_mask)];
+
+        if(length == 1) {
+            *begin = alpha;
+        }
+        else {
+            set_bytes(Addr(begin), alpha, length);
+        }
+    }
+
+    Void Coverage_Rasterizer::add_sample_run(V2s position, U32 length, U32 sample_mask) {
+        write_coverage(*this->mask, *this->lut, Sample_Run{ position, length, sample_mask });
+    }
+
+
     Void resolve(
         Ref<Image<Color_Bgra>> dst,
         Ref<const Image<Color_Rgba>> src,
@@ -401,6 +521,63 @@ namespace msaa {
     }
 
 
+    // fills [begin, end) by filling the first pixel and copying it.
+    inline Void fill_pixels(
+        Ptr<Color_Rgba> begin, Ptr<Color_Rgba> end, U16 sample_count,
+        Color_Rgba packed, U32x4 packed_x4
+    ) {
+        auto cursor = begin;
+
+        // fill first pixel.
+        auto first_end = begin + sample_count;
+        while(cursor + 4 <= first_end) {
+            Ptr<U32x4>(cursor)->store(packed_x4);
+            cursor += 4;
+        }
+        while(cursor < first_end) {
+            *cursor = packed;
+            cursor += 1;
+        }
+
+        // copy first pixel to remainder of span.
+        fill_copy_bytes(Addr(begin), Addr(end), Addr(cursor));
+    }
+
+    // fills the samples of a single pixel, creating masks ad hoc.
+    inline Void fill_pixel_masked(
+        Ptr<Color_Rgba> begin, U16 sample_count, U32 sample_mask,
+        Color_Rgba packed, U32x4 packed_x4
+    ) {
+        auto cursor = begin;
+        auto end    = begin + sample_count;
+
+        while(cursor + 4 <= end) {
+            auto mask_x4 = U32x4::unpack_bits(sample_mask);
+
+            auto at = Ptr<U32x4>(cursor);
+            at->store(
+                  (at->load() & ~mask_x4)
+                | (packed_x4  & mask_x4)
+            );
+
+            cursor += 4;
+            sample_mask >>= 4;
+        }
+        while(cursor < end) {
+            auto mask = mask_all_equal<U32>(sample_mask & 0x1);
+
+            auto at = cursor;
+            *at = Color_Rgba(
+                  (at->value    & ~mask)
+                | (packed.value & mask)
+            );
+
+            cursor += 1;
+            sample_mask >>= 1;
+        }
+    }
+
+
     Void fill_opaque(
         Ref<Image<Color_Rgba>> image,
         Ref<const List<Sample_Run>> sample_runs,
@@ -427,60 +604,194 @@ namespace msaa {
             auto end   = begin + length*image.sample_count;
 
             if(run.sample_mask == all_samples) {
-                auto cursor = begin;
+                fill_pixels(begin, end, image.sample_count, packed, packed_x4);
+            }
+            else if(length == 1) {
+                fill_pixel_masked(begin, image.sample_count, run.sample_mask, packed, packed_x4);
+            }
+            else {
+                throw "Unimplemented.";
+                // cache masks.
+                // loop using cached masks.
+            }
+        }
 
-                // fill first pixel.
-                auto first_end = begin + image.sample_count;
-                while(cursor + 4 <= first_end) {
-                    Ptr<U32x4>(cursor)->store(packed_x4);
-                    cursor += 4;
+    }
+
+
+    Occlusion Occlusion::create(U32 width, U32 height) {
+        auto occlusion = Occlusion();
+        occlusion.masks.set_length(Usize(width*height));
+        occlusion.lengths = V2u({ width, height });
+        occlusion.clear();
+        return occlusion;
+    }
+
+    Void Occlusion::clear() {
+        set_bytes(Addr(this->masks.get_values()), 0, this->masks.length*sizeof(U32));
+    }
+
+    Void Occlusion::_destroy() {
+        this->masks._destroy();
+    }
+
+
+    Void fill_opaque_front_to_back(
+        Ref<Image<Color_Rgba>> image,
+        Ref<Occlusion> occlusion,
+        Ref<const List<Sample_Run>> sample_runs,
+        V4f color
+    ) {
+        assert(occlusion.lengths.x() == image.lengths.x());
+        assert(occlusion.lengths.y() == image.lengths.y());
+
+        auto packed    = Color_Rgba::pack_255(color);
+        auto packed_x4 = U32x4(packed.value);
+
+        auto all_samples = mask_ending_at<U32>(image.sample_count);
+
+        for(const auto& run : sample_runs) {
+            auto x_begin = U32(clamp(run.position.x(),                   0, S32(image.lengths.x())));
+            auto x_end   = U32(clamp(run.position.x() + S32(run.length), 0, S32(image.lengths.x())));
+            auto length = x_end - x_begin;
+
+            if(    length == 0
+                || run.position.y() < 0
+                || U32(run.position.y()) >= image.lengths.y()
+            ) {
+                continue;
+            }
+
+            auto y = U32(run.position.y());
+            auto covered = &occlusion.masks[y*occlusion.lengths.x() + x_begin];
+            auto sample_mask = run.sample_mask & all_samples;
+
+            auto i = U32(0);
+            while(i < length) {
+                auto visible = sample_mask & ~covered[i];
+
+                // hidden by paths in front.
+                if(visible == 0) {
+                    i += 1;
+                    continue;
                 }
-                while(cursor < first_end) {
-                    *cursor = packed;
-                    cursor += 1;
+
+                auto begin = image.get_first_sample(x_begin + i, y);
+
+                if(visible == all_samples) {
+                    // extend over all uncovered pixels.
+                    auto end = i + 1;
+                    while(end < length && covered[end] == 0) {
+                        end += 1;
+                    }
+
+                    fill_pixels(begin, begin + (end - i)*image.sample_count, image.sample_count, packed, packed_x4);
+
+                    for(; i < end; i += 1) {
+                        covered[i] = all_samples;
+                    }
                 }
+                else {
+                    fill_pixel_masked(begin, image.sample_count, visible, packed, packed_x4);
 
-                // copy first pixel to remainder of span.
-                fill_copy_bytes(Addr(begin), Addr(end), Addr(cursor));
+                    covered[i] |= visible;
+                    i += 1;
+                }
             }
-            else if(length == 1) {
-                // fill pixel creating masks ad hoc.
+        }
+    }
 
-                auto cursor = begin;
-                auto sample_mask = run.sample_mask;
 
-                while(cursor + 4 <= end) {
-                    auto mask_x4 = U32x4::unpack_bits(sample_mask);
+    Void composite(
+        Ref<Image<Color_Bgra>> image,
+        Ref<const List<Sample_Run>> sample_runs,
+        Ref<const Lut> lut,
+        V4f color
+    ) {
+        composite(image, sample_runs.get_values(), sample_runs.length, lut, color);
+    }
+
+    Void composite(
+        Ref<Image<Color_Bgra>> image,
+        Ptr<const Sample_Run> sample_runs, Usize sample_run_count,
+        Ref<const Lut> lut,
+        V4f color
+    ) {
+        assert(image.sample_count == 1);
+
+        auto src = F32x4(color.b()*color.a(), color.g()*color.a(), color.r()*color.a(), color.a());
+        src = src * F32x4(255.0f);
+
+        auto is_opaque = (color.a() >= 1.0f);
+        auto packed    = Color_Bgra(_pack(src));
+        auto packed_x4 = U32x4(packed.value);
+
+        // pre-multiplied source and inverse alpha per sample count.
+        F32x4 sources[Lut::max_sample_count + 1];
+        F32x4 inv_alphas[Lut::max_sample_count + 1];
+        for(auto i : Range<Usize>(lut.sample_count + 1u)) {
+            auto coverage = F32(i) / F32(lut.sample_count);
+            sources[i]    = src * F32x4(coverage);
+            inv_alphas[i] = F32x4(1.0f - coverage*color.a());
+        }
 
-                    auto at = Ptr<U32x4>(cursor);
-                    at->store(
-                          (at->load() & ~mask_x4)
-                        | (packed_x4  & mask_x4)
-                    );
+        auto blend = [](Ptr<Color_Bgra> pixel, F32x4 src, F32x4 inv_alpha) -> Void {
+            auto dst = _unpack(pixel->value);
+            pixel->value = _pack(src + dst*inv_alpha);
+        };
+
+        for(auto i : Range<Usize>(sample_run_count)) {
+            const auto& run = sample_runs[i];
+            auto x_begin = U32(clamp(run.position.x(),                   0, S32(image.lengths.x())));
+            auto x_end   = U32(clamp(run.position.x() + S32(run.length), 0, S32(image.lengths.x())));
+            auto length = x_end - x_begin;
+
+            if(    length == 0
+                || run.position.y() < 0
+                || U32(run.position.y()) >= image.lengths.y()
+            ) {
+                continue;
+            }
 
+            auto begin = image.get_first_sample(x_begin, U32(run.position.y()));
+            auto end   = begin + length;
+
+            auto count = count_ones(run.sample_mask & lut.sample_mask);
+            if(count == 0) {
+                continue;
+            }
+
+            if(count == lut.sample_count && is_opaque) {
+                // solid fill.
+                auto cursor = begin;
+                while(cursor + 4 <= end) {
+                    Ptr<U32x4>(cursor)->store(packed_x4);
                     cursor += 4;
-                    sample_mask >>= 4;
                 }
                 while(cursor < end) {
-                    auto mask = mask_all_equal<U32>(sample_mask & 0x1);
-
-                    auto at = cursor;
-                    *at = Color_Rgba(
-                          (at->value    & ~mask)
-                        | (packed.value & mask)
-                    );
-
+                    *cursor = packed;
                     cursor += 1;
-                    sample_mask >>= 1;
                 }
             }
             else {
-                throw "Unimplemented.";
-                // cache masks.
-                // loop using cached masks.
+                for(auto cursor = begin; cursor < end; cursor += 1) {
+                    blend(cursor, sources[count], inv_alphas[count]);
+                }
             }
         }
+    }
+
 
+    Void fill_coverage(
+        Ref<Image<U8>> mask,
+        Ref<const List<Sample_Run>> sample_runs,
+        Ref<const Lut> lut
+    ) {
+        assert(mask.sample_count == 1);
+
+        for(const auto& run : sample_runs) {
+            write_coverage(mask, lut, run);
+        }
     }
 
 }}
@@ -47,6 +47,9 @@ namespace msaa {
         F32 min_a;
         U32 sample_mask;
 
+        // coverage[count_ones(mask)] is the 8 bit alpha of a pixel.
+        Array<U8, max_sample_count + 1> coverage;
+
         Lut() {}
         LPP_MOVE_IS_DESTROY_CTORS(Lut, Lut);
     };
@@ -64,6 +67,30 @@ namespace msaa {
         Ref<List<Sample_Run>> sample_runs
     );
 
+    Void rasterize(
+        Ptr<const Segment<V2f>> segments, Usize segment_count,
+        Ref<const Lut> lut,
+        Ref<List<Sample_Run>> sample_runs
+    );
+
+    // only generates runs inside the viewport.
+    Void rasterize(
+        Ptr<const Segment<V2f>> segments, Usize segment_count,
+        Viewport viewport,
+        Ref<const Lut> lut,
+        Ref<List<Sample_Run>> sample_runs
+    );
+
+
+    // intersects two run lists as produced by the rasterizer (sorted by y,
+    // then x, not overlapping). samples are kept if they are in both lists.
+    // appends to result.
+    Void clip(
+        Ref<const List<Sample_Run>> content,
+        Ref<const List<Sample_Run>> clip,
+        Ref<List<Sample_Run>> result
+    );
+
 
     struct Rasterizer : raster::Rasterizer {
         Ptr<const Lut> lut;
@@ -72,6 +99,7 @@ namespace msaa {
         List<V2f> normals;
         U8        scan_winding;
 
+        Rasterizer() {}
         Rasterizer(Ptr<const Lut> lut, Ptr<List<Sample_Run>> sample_runs) : lut(lut), sample_runs(sample_runs) {}
 
         virtual Void on_init() override;
@@ -80,12 +108,31 @@ namespace msaa {
 
         virtual Void _destroy() override;
 
-        Void add_sample_run(V2s position, U32 length, U32 sample_mask);
+        virtual Void add_sample_run(V2s position, U32 length, U32 sample_mask);
 
         LPP_MOVE_IS_DESTROY_CTORS(Rasterizer, Rasterizer);
     };
 
 
+    // writes coverage directly into an 8 bit mask. no sample runs are stored.
+    Void rasterize_coverage(
+        Ref<const List<Segment<V2f>>> segments,
+        Ref<const Lut> lut,
+        Ref<Image<U8>> mask
+    );
+
+    struct Coverage_Rasterizer : Rasterizer {
+        Ptr<Image<U8>> mask;
+
+        Coverage_Rasterizer() {}
+        Coverage_Rasterizer(Ptr<const Lut> lut, Ptr<Image<U8>> mask) : Rasterizer(lut, nullptr), mask(mask) {}
+
+        virtual Void add_sample_run(V2s position, U32 length, U32 sample_mask) override;
+
+        LPP_MOVE_IS_DESTROY_CTORS(Coverage_Rasterizer, Coverage_Rasterizer);
+    };
+
+
     Void resolve(
         Ref<Image<Color_Bgra>> dst,
         Ref<const Image<Color_Rgba>> src,
@@ -98,5 +145,52 @@ namespace msaa {
         V4f color
     );
 
+    // samples already written by paths in front, one mask per pixel.
+    struct Occlusion {
+        List<U32> masks;
+        V2u lengths;
+
+        static Occlusion create(U32 width, U32 height);
+
+        Void clear();
+
+        Void _destroy();
+
+        Occlusion() {}
+        LPP_MOVE_IS_DESTROY_CTORS(Occlusion, Occlusion);
+    };
+
+    // for opaque paths drawn front to back: only writes samples that are not
+    // covered yet and marks them as covered. fully hidden runs are skipped.
+    Void fill_opaque_front_to_back(
+        Ref<Image<Color_Rgba>> image,
+        Ref<Occlusion> occlusion,
+        Ref<const List<Sample_Run>> sample_runs,
+        V4f color
+    );
+
+    // blends color (not pre-multiplied) over a single-sampled, pre-multiplied
+    // image. full spans are solid fills, only edge pixels use the sample masks.
+    Void composite(
+        Ref<Image<Color_Bgra>> image,
+        Ref<const List<Sample_Run>> sample_runs,
+        Ref<const Lut> lut,
+        V4f color
+    );
+
+    Void composite(
+        Ref<Image<Color_Bgra>> image,
+        Ptr<const Sample_Run> sample_runs, Usize sample_run_count,
+        Ref<const Lut> lut,
+        V4f color
+    );
+
+    // mask must be single-sampled. pixels not touched by a run keep their value.
+    Void fill_coverage(
+        Ref<Image<U8>> mask,
+        Ref<const List<Sample_Run>> sample_runs,
+        Ref<const Lut> lut
+    );
+
 }}
 
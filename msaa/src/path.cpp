@@ -0,0 +1,368 @@
+#include "path.hpp"
+#include "flatten.hpp"
+
+
+namespace raster {
+
+    template <Usize degree>
+    Bool are_finite(Ptr<const Bezier<V2f, degree>> curves, U32 count) {
+        for(auto i : Range<U32>(count)) {
+            for(auto j : Range<Usize>(degree + 1)) {
+                if(!is_finite(curves[i][j])) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+
+    struct Baked_Path_Layout {
+        U64 b1s;
+        U64 b2s;
+        U64 b3s;
+        U64 indices;
+        U64 sub_paths;
+        U64 size;
+
+        static Baked_Path_Layout compute(Ref<const Baked_Path::Header> header) {
+            auto layout = Baked_Path_Layout();
+            layout.b1s       = align_16(sizeof(Baked_Path::Header));
+            layout.b2s       = align_16(layout.b1s       + U64(header.b1_count)      *sizeof(Bezier<V2f, 1>));
+            layout.b3s       = align_16(layout.b2s       + U64(header.b2_count)      *sizeof(Bezier<V2f, 2>));
+            layout.indices   = align_16(layout.b3s       + U64(header.b3_count)      *sizeof(Bezier<V2f, 3>));
+            layout.sub_paths = align_16(layout.indices   + U64(header.index_count)   *sizeof(Curve_Index));
+            layout.size      =          layout.sub_paths + U64(header.sub_path_count)*sizeof(Sub_Path);
+            return layout;
+        }
+    };
+
+
+
+    Baked_Path_View Baked_Path_View::from_bytes(Ptr<const Byte> bytes, Usize size) {
+        auto view = from_trusted_bytes(bytes, size);
+        view.validate();
+        return view;
+    }
+
+    Baked_Path_View Baked_Path_View::from_trusted_bytes(Ptr<const Byte> bytes, Usize size) {
+        if(size < sizeof(Baked_Path::Header)) {
+            throw "Baked path is truncated.";
+        }
+        if(Usize(bytes) % alignof(Baked_Path::Header) != 0) {
+            throw "Baked path is misaligned.";
+        }
+
+        const auto& header = *Ptr<const Baked_Path::Header>(bytes);
+        if(header.magic != Baked_Path::magic) {
+            throw "Not a baked path.";
+        }
+        if(header.version != Baked_Path::version) {
+            throw "Unsupported baked path version.";
+        }
+
+        // counts are u32, so the sizes can't overflow u64.
+        auto layout = Baked_Path_Layout::compute(header);
+        if(layout.size > U64(size)) {
+            throw "Baked path is truncated.";
+        }
+
+        auto view = Baked_Path_View();
+        view.b1s            = Ptr<const Bezier<V2f, 1>>(bytes + layout.b1s);
+        view.b2s            = Ptr<const Bezier<V2f, 2>>(bytes + layout.b2s);
+        view.b3s            = Ptr<const Bezier<V2f, 3>>(bytes + layout.b3s);
+        view.indices        = Ptr<const Curve_Index>   (bytes + layout.indices);
+        view.sub_paths      = Ptr<const Sub_Path>      (bytes + layout.sub_paths);
+        view.b1_count       = header.b1_count;
+        view.b2_count       = header.b2_count;
+        view.b3_count       = header.b3_count;
+        view.index_count    = header.index_count;
+        view.sub_path_count = header.sub_path_count;
+        return view;
+    }
+
+    Void Baked_Path_View::validate() const {
+        // points.
+        if(    !are_finite(this->b1s, this->b1_count)
+            || !are_finite(this->b2s, this->b2_count)
+            || !are_finite(this->b3s, this->b3_count)
+        ) {
+            throw "Baked path has non-finite points.";
+        }
+
+        // indices.
+        for(auto i : Range<U32>(this->index_count)) {
+            auto index = this->indices[i];
+
+            auto count = U32(0);
+            switch(index.kind()) {
+                case Curve_Kind::bezier_1: count = this->b1_count; break;
+                case Curve_Kind::bezier_2: count = this->b2_count; break;
+                case Curve_Kind::bezier_3: count = this->b3_count; break;
+                default: throw "Baked path has an invalid curve kind.";
+            }
+
+            if(index.index() >= count) {
+                throw "Baked path has an invalid curve index.";
+            }
+        }
+
+        // sub-paths.
+        for(auto i : Range<U32>(this->sub_path_count)) {
+            const auto& sub_path = this->sub_paths[i];
+
+            if(    sub_path.indices._begin > sub_path.indices._end
+                || sub_path.indices._end   > this->index_count
+            ) {
+                throw "Baked path has an invalid sub-path range.";
+            }
+            if((sub_path.flags & ~Sub_Path::closed) != 0) {
+                throw "Baked path has invalid sub-path flags.";
+            }
+
+            for(auto j : Range<U32>(sub_path.indices._begin + 1, sub_path.indices._end)) {
+                auto prev = this->get_last_point(this->indices[j - 1]);
+                auto next = this->get_first_point(this->indices[j]);
+                if(!equal(prev, next)) {
+                    throw "Baked path has a disconnected sub-path.";
+                }
+            }
+        }
+    }
+
+    V2f Baked_Path_View::get_first_point(Curve_Index index) const {
+        switch(index.kind()) {
+            case Curve_Kind::bezier_1: return this->b1s[index.index()][0];
+            case Curve_Kind::bezier_2: return this->b2s[index.index()][0];
+            case Curve_Kind::bezier_3: return this->b3s[index.index()][0];
+        }
+        throw "Invalid curve kind.";
+    }
+
+    V2f Baked_Path_View::get_last_point(Curve_Index index) const {
+        switch(index.kind()) {
+            case Curve_Kind::bezier_1: return this->b1s[index.index()][1];
+            case Curve_Kind::bezier_2: return this->b2s[index.index()][2];
+            case Curve_Kind::bezier_3: return this->b3s[index.index()][3];
+        }
+        throw "Invalid curve kind.";
+    }
+
+
+
+    Void Baked_Path::move_to(V2f p0) {
+        this->current_point     = p0;
+        this->start_point       = p0;
+        this->has_current_point = true;
+
+        // reuse an empty trailing sub-path.
+        if(    this->sub_paths.length > 0
+            && this->sub_paths.last_unchecked().indices.length() == 0
+        ) {
+            this->sub_paths.last_unchecked().flags = 0;
+            return;
+        }
+
+        auto begin = U32(this->indices.length);
+        this->sub_paths.append_new(Sub_Path{ Range<U32>(begin, begin), 0 });
+    }
+
+    Void Baked_Path::append_curve(Curve_Kind kind, U32 index, V2f last_point) {
+        if(index > Curve_Index::max_index) {
+            throw "Too many curves.";
+        }
+
+        this->indices.append_new(kind, index);
+        this->sub_paths.last_unchecked().indices._end = U32(this->indices.length);
+        this->current_point = last_point;
+    }
+
+    Void Baked_Path::line_to(V2f p1) {
+        if(!this->has_current_point) {
+            throw "No current point.";
+        }
+
+        this->b1s.append_new(Bezier<V2f, 1>({ this->current_point, p1 }));
+        this->append_curve(Curve_Kind::bezier_1, U32(this->b1s.length - 1), p1);
+    }
+
+    Void Baked_Path::quad_to(V2f p1, V2f p2) {
+        if(!this->has_current_point) {
+            throw "No current point.";
+        }
+
+        this->b2s.append_new(Bezier<V2f, 2>({ this->current_point, p1, p2 }));
+        this->append_curve(Curve_Kind::bezier_2, U32(this->b2s.length - 1), p2);
+    }
+
+    Void Baked_Path::cubic_to(V2f p1, V2f p2, V2f p3) {
+        if(!this->has_current_point) {
+            throw "No current point.";
+        }
+
+        this->b3s.append_new(Bezier<V2f, 3>({ this->current_point, p1, p2, p3 }));
+        this->append_curve(Curve_Kind::bezier_3, U32(this->b3s.length - 1), p3);
+    }
+
+    Void Baked_Path::close() {
+        if(!this->has_current_point) {
+            throw "No current point.";
+        }
+
+        if(!equal(this->current_point, this->start_point)) {
+            this->line_to(this->start_point);
+        }
+        this->sub_paths.last_unchecked().flags |= Sub_Path::closed;
+
+        // following curves start a new sub-path at the start point.
+        this->move_to(this->start_point);
+    }
+
+
+    Void Baked_Path::reserve(U32 b1_count, U32 b2_count, U32 b3_count, U32 sub_path_count) {
+        this->b1s.reserve(this->b1s.length + b1_count);
+        this->b2s.reserve(this->b2s.length + b2_count);
+        this->b3s.reserve(this->b3s.length + b3_count);
+        this->indices.reserve(this->indices.length + b1_count + b2_count + b3_count);
+        this->sub_paths.reserve(this->sub_paths.length + sub_path_count);
+    }
+
+    Void Baked_Path::add_polygon(Ptr<const V2f> points, U32 count, Bool is_closed) {
+        if(count == 0) {
+            return;
+        }
+
+        this->reserve(count, 0, 0, 2);
+
+        this->move_to(points[0]);
+        for(auto i : Range<U32>(1, count)) {
+            this->line_to(points[i]);
+        }
+
+        if(is_closed) {
+            this->close();
+        }
+    }
+
+    Void Baked_Path::add_cubic_chain(Ptr<const V2f> points, U32 cubic_count, Bool is_closed) {
+        this->reserve(is_closed ? 1 : 0, 0, cubic_count, 2);
+
+        this->move_to(points[0]);
+        for(auto i : Range<U32>(cubic_count)) {
+            auto p = points + 3*i;
+            this->cubic_to(p[1], p[2], p[3]);
+        }
+
+        if(is_closed) {
+            this->close();
+        }
+    }
+
+
+    Baked_Path_View Baked_Path::get_view() const {
+        auto view = Baked_Path_View();
+        view.b1s            = this->b1s.get_values();
+        view.b2s            = this->b2s.get_values();
+        view.b3s            = this->b3s.get_values();
+        view.indices        = this->indices.get_values();
+        view.sub_paths      = this->sub_paths.get_values();
+        view.b1_count       = U32(this->b1s.length);
+        view.b2_count       = U32(this->b2s.length);
+        view.b3_count       = U32(this->b3s.length);
+        view.index_count    = U32(this->indices.length);
+        view.sub_path_count = U32(this->sub_paths.length);
+        return view;
+    }
+
+    inline Baked_Path::Header make_header(Ref<const Baked_Path> path) {
+        auto header = Baked_Path::Header();
+        header.magic          = Baked_Path::magic;
+        header.version        = Baked_Path::version;
+        header.b1_count       = U32(path.b1s.length);
+        header.b2_count       = U32(path.b2s.length);
+        header.b3_count       = U32(path.b3s.length);
+        header.index_count    = U32(path.indices.length);
+        header.sub_path_count = U32(path.sub_paths.length);
+        header.reserved       = 0;
+        return header;
+    }
+
+    Usize Baked_Path::get_serialized_size() const {
+        return Usize(Baked_Path_Layout::compute(make_header(*this)).size);
+    }
+
+    Void Baked_Path::serialize(Ptr<Byte> bytes) const {
+        auto header = make_header(*this);
+        auto layout = Baked_Path_Layout::compute(header);
+
+        // zero the padding.
+        set_bytes(Addr(bytes), 0, Usize(layout.size));
+
+        copy_bytes(Addr(bytes), Addr(&header), sizeof(header));
+        copy_bytes(Addr(bytes + layout.b1s),       Addr(this->b1s.values),       this->b1s.length      *sizeof(Bezier<V2f, 1>));
+        copy_bytes(Addr(bytes + layout.b2s),       Addr(this->b2s.values),       this->b2s.length      *sizeof(Bezier<V2f, 2>));
+        copy_bytes(Addr(bytes + layout.b3s),       Addr(this->b3s.values),       this->b3s.length      *sizeof(Bezier<V2f, 3>));
+        copy_bytes(Addr(bytes + layout.indices),   Addr(this->indices.values),   this->indices.length  *sizeof(Curve_Index));
+        copy_bytes(Addr(bytes + layout.sub_paths), Addr(this->sub_paths.values), this->sub_paths.length*sizeof(Sub_Path));
+    }
+
+
+    Void Baked_Path::clear() {
+        this->b1s.length       = 0;
+        this->b2s.length       = 0;
+        this->b3s.length       = 0;
+        this->indices.length   = 0;
+        this->sub_paths.length = 0;
+        this->has_current_point = false;
+    }
+
+    Void Baked_Path::_destroy() {
+        this->b1s._destroy();
+        this->b2s._destroy();
+        this->b3s._destroy();
+        this->indices._destroy();
+        this->sub_paths._destroy();
+    }
+
+
+
+    Void flatten(Ref<const Baked_Path_View> path, F32 tolerance, Ref<List<Segment<V2f>>> segments) {
+        flatten(path, Transform::identity(), tolerance, segments);
+    }
+
+    Void flatten(Ref<const Baked_Path_View> path, Ref<const Transform> transform, F32 tolerance, Ref<List<Segment<V2f>>> segments) {
+        for(auto i : Range<U32>(path.sub_path_count)) {
+            const auto& sub_path = path.sub_paths[i];
+            if(sub_path.indices.length() == 0) {
+                continue;
+            }
+
+            for(auto j : sub_path.indices) {
+                auto index = path.indices[j];
+                switch(index.kind()) {
+                    case Curve_Kind::bezier_1: {
+                        const auto& b1 = path.b1s[index.index()];
+                        segments.append_new(Segment<V2f>({ transform.apply(b1[0]), transform.apply(b1[1]) }));
+                    } break;
+
+                    case Curve_Kind::bezier_2: {
+                        flatten(path.b2s[index.index()], transform, tolerance, segments);
+                    } break;
+
+                    case Curve_Kind::bezier_3: {
+                        flatten(path.b3s[index.index()], transform, tolerance, segments);
+                    } break;
+                }
+            }
+
+            // close.
+            auto first = path.get_first_point(path.indices[sub_path.indices._begin]);
+            auto last  = path.get_last_point(path.indices[sub_path.indices._end - 1]);
+            if(!equal(first, last)) {
+                segments.append_new(Segment<V2f>({ transform.apply(last), transform.apply(first) }));
+            }
+        }
+    }
+
+}
+
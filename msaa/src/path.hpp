@@ -0,0 +1,147 @@
+#pragma once
+
+#include "common.hpp"
+
+
+namespace raster {
+
+    enum class Curve_Kind : U32 {
+        bezier_1 = 1,
+        bezier_2,
+        bezier_3,
+    };
+
+    struct Curve_Index {
+        static constexpr Usize kind_bit_count = 2;
+        static constexpr U32   max_index      = U32(-1) >> kind_bit_count;
+
+        Curve_Index() {}
+        Curve_Index(Curve_Kind kind, U32 index)
+            : value(U32(kind) | (index << kind_bit_count)) {}
+
+        Curve_Kind kind() const {
+            return Curve_Kind(value & mask_ending_at<U32>(kind_bit_count));
+        }
+
+        U32 index() const {
+            return value >> kind_bit_count;
+        }
+
+        U32 value;
+    };
+
+    struct Sub_Path {
+        static constexpr U32 closed = 1;
+
+        Range<U32> indices;
+        U32 flags;
+
+        Bool is_closed() const { return (this->flags & closed) != 0; }
+    };
+
+
+    /* Baked_Path_View
+        - read only view of a baked path. does not own the arrays.
+        - curves of a sub-path are consecutive: each curve starts where the
+          previous one ended.
+        - from_bytes views a serialized path in place. it validates the data
+          and throws if it is malformed, so the view can be trusted after.
+    */
+    struct Baked_Path_View {
+        Ptr<const Bezier<V2f, 1>> b1s;
+        Ptr<const Bezier<V2f, 2>> b2s;
+        Ptr<const Bezier<V2f, 3>> b3s;
+        Ptr<const Curve_Index>    indices;
+        Ptr<const Sub_Path>       sub_paths;
+        U32 b1_count;
+        U32 b2_count;
+        U32 b3_count;
+        U32 index_count;
+        U32 sub_path_count;
+
+        static Baked_Path_View from_bytes(Ptr<const Byte> bytes, Usize size);
+
+        // from_bytes without validate, for bytes that were validated
+        // before. only the header and the size are checked.
+        static Baked_Path_View from_trusted_bytes(Ptr<const Byte> bytes, Usize size);
+
+        Void validate() const;
+
+        V2f get_first_point(Curve_Index index) const;
+        V2f get_last_point(Curve_Index index)  const;
+    };
+
+
+    /* Baked_Path
+        - curves are stored by kind in separate lists, so there are no unused
+          control points. indices keep the drawing order.
+        - built with move_to/line_to/quad_to/cubic_to/close, or in bulk with
+          add_polygon/add_cubic_chain which reserve once.
+        - serialize writes a header and the 5 arrays, each 16 byte aligned
+          relative to the start of the buffer.
+    */
+    struct Baked_Path {
+        static constexpr U32 magic   = 0x48544150; // "PATH"
+        static constexpr U32 version = 1;
+
+        struct Header {
+            U32 magic;
+            U32 version;
+            U32 b1_count;
+            U32 b2_count;
+            U32 b3_count;
+            U32 index_count;
+            U32 sub_path_count;
+            U32 reserved;
+        };
+
+
+        List<Bezier<V2f, 1>> b1s;
+        List<Bezier<V2f, 2>> b2s;
+        List<Bezier<V2f, 3>> b3s;
+        List<Curve_Index> indices;
+        List<Sub_Path> sub_paths;
+
+        // builder state.
+        V2f  current_point;
+        V2f  start_point;
+        Bool has_current_point = false;
+
+
+        Void move_to(V2f p0);
+        Void line_to(V2f p1);
+        Void quad_to(V2f p1, V2f p2);
+        Void cubic_to(V2f p1, V2f p2, V2f p3);
+        Void close();
+
+        Void reserve(U32 b1_count, U32 b2_count, U32 b3_count, U32 sub_path_count);
+
+        // one sub-path of count - 1 lines.
+        Void add_polygon(Ptr<const V2f> points, U32 count, Bool is_closed);
+
+        // one sub-path of cubics. points has 1 + 3*cubic_count entries.
+        Void add_cubic_chain(Ptr<const V2f> points, U32 cubic_count, Bool is_closed);
+
+        Baked_Path_View get_view() const;
+
+        Usize get_serialized_size() const;
+        Void serialize(Ptr<Byte> bytes) const;
+
+        Void clear();
+
+        Void _destroy();
+
+        Baked_Path() {}
+        LPP_MOVE_IS_DESTROY_CTORS(Baked_Path, Baked_Path);
+
+
+        Void append_curve(Curve_Kind kind, U32 index, V2f last_point);
+    };
+
+
+    // sub-paths are closed implicitly, as needed for filling.
+    Void flatten(Ref<const Baked_Path_View> path, F32 tolerance, Ref<List<Segment<V2f>>> segments);
+    Void flatten(Ref<const Baked_Path_View> path, Ref<const Transform> transform, F32 tolerance, Ref<List<Segment<V2f>>> segments);
+
+}
+
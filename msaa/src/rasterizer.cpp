@@ -1,12 +1,26 @@
 #include "rasterizer.hpp"
 
-#include <algorithm>
+#include <cfloat>
+#include <utility>
 
 
 namespace raster {
 
     Void Rasterizer::run(Ref<const List<Segment<V2f>>> segments) {
-        this->init(segments);
+        this->run(segments.get_values(), segments.length);
+    }
+
+    Void Rasterizer::run(Ptr<const Segment<V2f>> segments, Usize segment_count) {
+        this->init(segments, segment_count);
+
+        while(this->advance_scanline()) {
+            while(this->advance_fragment()) {
+            }
+        }
+    }
+
+    Void Rasterizer::run(Ptr<const Segment<V2f>> segments, Usize segment_count, Viewport viewport) {
+        this->init(segments, segment_count, viewport);
 
         while(this->advance_scanline()) {
             while(this->advance_fragment()) {
@@ -39,20 +53,231 @@ namespace raster {
     }
 
     Void Rasterizer::init(Ref<const List<Segment<V2f>>> segments) {
+        this->init(segments.get_values(), segments.length);
+    }
+
+    Void Rasterizer::init(Ptr<const Segment<V2f>> segments, Usize segment_count) {
         // create infos.
-        this->infos.reserve(segments.length);
+        this->infos.reserve(segment_count);
         this->infos.length = 0;
-        for(auto segment : segments) {
-            this->infos.append_new(segment);
+        for(auto i : Range<Usize>(segment_count)) {
+            this->infos.append_new(segments[i]);
         }
 
-        // sort infos by y.
-        std::sort(
-            this->infos.begin().value, this->infos.end().value,
-            [](const auto& a, const auto& b) {
-                return a.get_y_min() <= b.get_y_min();
+        this->has_viewport = false;
+        this->init_scan();
+    }
+
+
+    // point on p0-p1 with p[axis] == target. target must be in range.
+    inline V2f get_axis_point(U8 axis, F32 target, V2f p0, V2f p1) {
+        auto t = inverse_lerp(target, p0[axis], p1[axis]);
+        t = clamp(t, 0.0f, 1.0f);
+
+        V2f result;
+        result[axis]      = target;
+        result[1u - axis] = lerp(p0[1u - axis], p1[1u - axis], t);
+        return result;
+    }
+
+    Void Rasterizer::init(Ptr<const Segment<V2f>> segments, Usize segment_count, Viewport viewport) {
+        auto x_min = F32(viewport.min.x());
+        auto y_min = F32(viewport.min.y());
+        auto x_max = F32(viewport.max.x());
+        auto y_max = F32(viewport.max.y());
+
+        auto add_segment = [&](V2f p0, V2f p1) {
+            if(p0.x() != p1.x() || p0.y() != p1.y()) {
+                this->infos.append_new(Segment<V2f>({ p0, p1 }));
+            }
+        };
+
+        this->infos.reserve(segment_count);
+        this->infos.length = 0;
+        for(auto i : Range<Usize>(segment_count)) {
+            auto p0 = segments[i].p0();
+            auto p1 = segments[i].p1();
+
+            // cull above, below, right.
+            if(    max(p0.y(), p1.y()) <= y_min
+                || min(p0.y(), p1.y()) >= y_max
+                || min(p0.x(), p1.x()) >= x_max
+            ) {
+                continue;
+            }
+
+            // clip y.
+            {
+                auto a = p0;
+                auto b = p1;
+                if(a.y() < y_min) { p0 = get_axis_point(1, y_min, a, b); }
+                if(a.y() > y_max) { p0 = get_axis_point(1, y_max, a, b); }
+                if(b.y() < y_min) { p1 = get_axis_point(1, y_min, a, b); }
+                if(b.y() > y_max) { p1 = get_axis_point(1, y_max, a, b); }
             }
-        );
+
+            // clip right.
+            if(min(p0.x(), p1.x()) >= x_max) {
+                continue;
+            }
+            if(p0.x() > x_max) { p0 = get_axis_point(0, x_max, p1, p0); }
+            if(p1.x() > x_max) { p1 = get_axis_point(0, x_max, p0, p1); }
+
+            // collapse left.
+            if(max(p0.x(), p1.x()) <= x_min) {
+                add_segment(V2f({ x_min, p0.y() }), V2f({ x_min, p1.y() }));
+            }
+            else if(p0.x() < x_min) {
+                auto c = get_axis_point(0, x_min, p0, p1);
+                add_segment(V2f({ x_min, p0.y() }), c);
+                add_segment(c, p1);
+            }
+            else if(p1.x() < x_min) {
+                auto c = get_axis_point(0, x_min, p0, p1);
+                add_segment(p0, c);
+                add_segment(c, V2f({ x_min, p1.y() }));
+            }
+            else {
+                add_segment(p0, p1);
+            }
+        }
+
+        this->has_viewport = true;
+        this->viewport     = viewport;
+        this->init_scan();
+    }
+
+    Void Rasterizer::sort_infos() {
+        auto infos = this->infos.begin().value;
+        auto count = U32(this->infos.length);
+        if(count == 0) {
+            return;
+        }
+
+        // scanlines add infos while y_min < scanline_end, so infos only need
+        // to be ordered by floor(y_min).
+        auto keys = &this->sort.keys;
+        keys->reserve(count);
+        keys->length = count;
+
+        auto key_min    = s32_max;
+        auto key_max    = s32_min;
+        auto is_ordered = true;
+        for(auto i : Range<U32>(count)) {
+            auto key = floor_to_s32(infos[i].get_y_min());
+            (*keys)[i] = key;
+            is_ordered = is_ordered && key >= key_max;
+            key_min = min(key_min, key);
+            key_max = max(key_max, key);
+        }
+
+        if(is_ordered) {
+            return;
+        }
+
+        // sparse: a bucket per scanline would cost more than sorting.
+        auto bucket_count = U64(S64(key_max) - S64(key_min)) + 1;
+        if(bucket_count > 4*U64(count) + 64) {
+            this->radix_sort_infos();
+            return;
+        }
+
+        // counting sort.
+        auto offsets = &this->sort.offsets;
+        offsets->reserve(Usize(bucket_count));
+        offsets->length = Usize(bucket_count);
+        set_bytes(Addr(offsets->begin().value), 0, Usize(bucket_count)*sizeof(U32));
+
+        for(auto key : *keys) {
+            (*offsets)[U32(key - key_min)] += 1;
+        }
+
+        auto total = U32(0);
+        for(auto& offset : *offsets) {
+            auto length = offset;
+            offset = total;
+            total += length;
+        }
+
+        auto sorted = &this->sort.infos;
+        sorted->reserve(count);
+        sorted->length = count;
+        for(auto i : Range<U32>(count)) {
+            auto& offset = (*offsets)[U32((*keys)[i] - key_min)];
+            (*sorted)[offset] = infos[i];
+            offset += 1;
+        }
+
+        lpp::swap(&this->infos, sorted);
+    }
+
+    Void Rasterizer::radix_sort_infos() {
+        auto infos = this->infos.begin().value;
+        auto count = U32(this->infos.length);
+
+        // (key, index) pairs, so the passes don't move the infos.
+        // keys are biased to sort as unsigned.
+        auto src = &this->sort.pairs[0];
+        auto dst = &this->sort.pairs[1];
+        src->reserve(count);
+        dst->reserve(count);
+        src->length = count;
+        dst->length = count;
+
+        auto changed_bits = U32(0);
+        auto first_key    = U32(this->sort.keys[0]) ^ 0x80000000u;
+        for(auto i : Range<U32>(count)) {
+            auto key = U32(this->sort.keys[i]) ^ 0x80000000u;
+            changed_bits |= key ^ first_key;
+            (*src)[i] = (U64(key) << 32) | U64(i);
+        }
+
+        // lsd, 8 bits per pass. bytes that are the same for all keys are
+        // skipped.
+        U32 counts[256];
+        for(auto pass : Range<U32>(4)) {
+            auto shift = 32 + 8*pass;
+            if(((changed_bits >> (8*pass)) & 0xff) == 0) {
+                continue;
+            }
+
+            set_bytes(Addr(counts), 0, sizeof(counts));
+            for(auto pair : *src) {
+                counts[(pair >> shift) & 0xff] += 1;
+            }
+
+            auto total = U32(0);
+            for(auto& offset : counts) {
+                auto length = offset;
+                offset = total;
+                total += length;
+            }
+
+            auto values = dst->begin().value;
+            for(auto pair : *src) {
+                auto& offset = counts[(pair >> shift) & 0xff];
+                values[offset] = pair;
+                offset += 1;
+            }
+
+            auto temp = src;
+            src = dst;
+            dst = temp;
+        }
+
+        // gather.
+        auto sorted = &this->sort.infos;
+        sorted->reserve(count);
+        sorted->length = count;
+        for(auto i : Range<U32>(count)) {
+            (*sorted)[i] = infos[U32((*src)[i])];
+        }
+
+        lpp::swap(&this->infos, sorted);
+    }
+
+    Void Rasterizer::init_scan() {
+        this->sort_infos();
 
 
         // init scanline.
@@ -128,6 +353,11 @@ namespace raster {
                     info.get_bottom_point(), info.get_top_point()
                 );
 
+                // lerp(a, a, t) isn't always a.
+                if(info.is_vertical) {
+                    top.x() = bottom.x();
+                }
+
 
                 // y_mid intersection.
                 auto y_mid = F32(scan->position) + 0.5f;
@@ -148,8 +378,18 @@ namespace raster {
                         t = (y_mid - y_min) / dy;
                     }
 
-                    auto position = lerp(bottom.x(), top.x(), t);
+                    auto position = info.is_vertical ? bottom.x() : lerp(bottom.x(), top.x(), t);
                     auto fragment = lpp::floor(position);
+
+                    // the segment isn't active in the fragment starting at
+                    // its right end. count the crossing in the one before.
+                    if(    !info.is_vertical
+                        && fragment == position
+                        && position >= segment.right().x()
+                    ) {
+                        fragment -= 1.0f;
+                    }
+
                     segment.y_mid_fragment = S32(fragment);
                 }
                 else {
@@ -222,7 +462,7 @@ namespace raster {
         if(frag->position >= frag->next_segment_position) {
             auto x_min = F32();
             while( this->get_next_scanline_active_x_min(x_min)
-                && x_min <= this->fragment_end()
+                && x_min < this->fragment_end()
             ) {
                 auto segment_index = scan->actives[frag->scanline_active_cursor];
 
@@ -252,7 +492,10 @@ namespace raster {
             auto left  = scan_segment.left();
             auto right = scan_segment.right();
 
-            if(right.x() <= this->fragment_begin()) {
+            // vertical segments on the left edge stay for one fragment.
+            if(    right.x() < this->fragment_begin()
+                || (right.x() == this->fragment_begin() && !this->infos[segment_index].is_vertical)
+            ) {
                 // TODO: remove swap.
                 frag->actives[i] = frag->actives.last_unchecked();
                 frag->actives.length -= 1;
@@ -313,6 +556,11 @@ namespace raster {
 
     Void Rasterizer::_destroy() {
         this->infos._destroy();
+        this->sort.keys._destroy();
+        this->sort.offsets._destroy();
+        this->sort.pairs[0]._destroy();
+        this->sort.pairs[1]._destroy();
+        this->sort.infos._destroy();
         this->scanline.segments._destroy();
         this->scanline.actives._destroy();
         this->fragment.segments._destroy();
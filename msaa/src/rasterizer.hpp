@@ -6,10 +6,29 @@
 namespace raster {
 
 
+    // pixel rect [min, max).
+    struct Viewport {
+        V2s min;
+        V2s max;
+
+        static Viewport from_lengths(V2u lengths) {
+            return Viewport{ V2s({ 0, 0 }), V2s({ S32(lengths.x()), S32(lengths.y()) }) };
+        }
+    };
+
+
     struct Rasterizer {
         Void run(Ref<const List<Segment<V2f>>> segments);
+        Void run(Ptr<const Segment<V2f>> segments, Usize segment_count);
+        Void run(Ptr<const Segment<V2f>> segments, Usize segment_count, Viewport viewport);
 
         Void init(Ref<const List<Segment<V2f>>> segments);
+        Void init(Ptr<const Segment<V2f>> segments, Usize segment_count);
+
+        // segments above, below or right of the viewport are dropped.
+        // segments left of it become vertical segments at viewport.min.x, so
+        // the winding inside does not change. nothing outside is generated.
+        Void init(Ptr<const Segment<V2f>> segments, Usize segment_count, Viewport viewport);
         Bool advance_scanline();
         Bool advance_fragment();
 
@@ -69,6 +88,18 @@ namespace raster {
 
         List<Segment_Info> infos;
 
+        // infos are bucketed by scanline in O(n). sparse scanline ranges
+        // are radix sorted instead.
+        struct {
+            List<S32> keys;
+            List<U32> offsets;
+            List<U64> pairs[2];
+            List<Segment_Info> infos;
+        } sort;
+
+        Bool     has_viewport;
+        Viewport viewport;
+
         struct {
             List<Scan_Segment> segments;
             List<U32> actives;
@@ -98,6 +129,10 @@ namespace raster {
         S32 fragment_begin() const { return this->fragment.position; }
         S32 fragment_end()   const { return this->fragment.position + 1; }
 
+        Void sort_infos();
+        Void radix_sort_infos();
+        Void init_scan();
+
         Rasterizer() {}
         LPP_MOVE_IS_DESTROY_CTORS(Rasterizer, Rasterizer);
     };
@@ -0,0 +1,90 @@
+#include "scene.hpp"
+
+
+namespace raster {
+
+    Void Scene::add_path(Ref<const List<Segment<V2f>>> segments, V4f color) {
+        auto path = Path();
+        path.segments_begin = U32(this->segments.length);
+        path.color          = color;
+
+        this->segments.reserve(this->segments.length + segments.length);
+        for(const auto& segment : segments) {
+            this->segments.append_new(segment);
+        }
+
+        path.segments_end = U32(this->segments.length);
+        this->paths.append_new(path);
+    }
+
+    Void Scene::_destroy() {
+        this->segments._destroy();
+        this->paths._destroy();
+    }
+
+}
+
+namespace raster {
+namespace msaa {
+
+    Void render(
+        Ref<Image<Color_Bgra>> image,
+        Ref<const Scene> scene,
+        Ref<const Lut> lut
+    ) {
+        auto viewport    = Viewport::from_lengths(image.lengths);
+        auto sample_runs = List<Sample_Run>();
+        auto rasterizer  = Rasterizer(&lut, &sample_runs);
+
+        for(const auto& path : scene.paths) {
+            if(path.color.a() <= 0.0f) {
+                continue;
+            }
+
+            sample_runs.length = 0;
+            rasterizer.run(scene.get_segments(path), path.segment_count(), viewport);
+
+            composite(image, sample_runs, lut, path.color);
+        }
+
+        rasterizer._destroy();
+        sample_runs._destroy();
+    }
+
+
+    Void render_front_to_back(
+        Ref<Image<Color_Rgba>> image,
+        Ref<const Scene> scene,
+        Ref<const Lut> lut
+    ) {
+        // before anything is drawn or allocated.
+        for(const auto& path : scene.paths) {
+            if(path.color.a() > 0.0f && path.color.a() < 1.0f) {
+                throw "Translucent paths are not supported.";
+            }
+        }
+
+        auto viewport    = Viewport::from_lengths(image.lengths);
+        auto occlusion   = Occlusion::create(image.lengths.x(), image.lengths.y());
+        auto sample_runs = List<Sample_Run>();
+        auto rasterizer  = Rasterizer(&lut, &sample_runs);
+
+        for(auto i = scene.paths.length; i > 0; i -= 1) {
+            const auto& path = scene.paths[i - 1];
+
+            if(path.color.a() <= 0.0f) {
+                continue;
+            }
+
+            sample_runs.length = 0;
+            rasterizer.run(scene.get_segments(path), path.segment_count(), viewport);
+
+            fill_opaque_front_to_back(image, occlusion, sample_runs, path.color);
+        }
+
+        rasterizer._destroy();
+        sample_runs._destroy();
+        occlusion._destroy();
+    }
+
+}}
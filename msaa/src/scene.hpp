@@ -0,0 +1,59 @@
+#pragma once
+
+#include "common.hpp"
+#include "msaa.hpp"
+
+
+namespace raster {
+
+    /* Scene
+        - flattened paths in draw order.
+        - all segments live in one list, paths refer to ranges of it.
+    */
+    struct Scene {
+        struct Path {
+            U32 segments_begin;
+            U32 segments_end;
+            V4f color;
+
+            U32 segment_count() const { return this->segments_end - this->segments_begin; }
+        };
+
+        List<Segment<V2f>> segments;
+        List<Path> paths;
+
+
+        Void add_path(Ref<const List<Segment<V2f>>> segments, V4f color);
+
+        Ptr<const Segment<V2f>> get_segments(Ref<const Path> path) const {
+            return this->segments.get_values() + path.segments_begin;
+        }
+
+        Void _destroy();
+
+        Scene() {}
+        LPP_MOVE_IS_DESTROY_CTORS(Scene, Scene);
+    };
+
+}
+
+namespace raster {
+namespace msaa {
+
+    // composites the paths of the scene in draw order onto image.
+    // no multi-sampled image is allocated.
+    Void render(
+        Ref<Image<Color_Bgra>> image,
+        Ref<const Scene> scene,
+        Ref<const Lut> lut
+    );
+
+    // renders opaque scenes front to back, so every sample is written at most
+    // once. throws for translucent paths before drawing anything.
+    Void render_front_to_back(
+        Ref<Image<Color_Rgba>> image,
+        Ref<const Scene> scene,
+        Ref<const Lut> lut
+    );
+
+}}
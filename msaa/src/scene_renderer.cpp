@@ -0,0 +1,118 @@
+#include "scene_renderer.hpp"
+
+
+namespace raster {
+namespace msaa {
+
+    // first run with y >= y. runs are sorted by y.
+    inline Usize find_row(Ref<const List<Sample_Run>> sample_runs, S32 y) {
+        auto begin = Usize(0);
+        auto end   = sample_runs.length;
+        while(begin < end) {
+            auto middle = begin + (end - begin)/2;
+            if(sample_runs[middle].position.y() < y) {
+                begin = middle + 1;
+            }
+            else {
+                end = middle;
+            }
+        }
+        return begin;
+    }
+
+
+    Scene_Renderer Scene_Renderer::create(Ptr<Work_Pool> pool, Ptr<const Lut> lut) {
+        auto renderer = Scene_Renderer();
+        renderer.pool = pool;
+        renderer.lut  = lut;
+
+        auto thread_count = pool->get_thread_count();
+        renderer.workers.reserve(thread_count);
+        for(auto i : Range<U32>(thread_count)) {
+            LPP_UNUSED(i);
+            auto& worker = renderer.workers.append_empty();
+            new (&worker.rasterizer) Rasterizer(lut, nullptr);
+            new (&worker.segments) List<Segment<V2f>>();
+        }
+
+        return renderer;
+    }
+
+    Void Scene_Renderer::render(Ref<Image<Color_Bgra>> image, Ref<const Baked_Scene_View> scene, F32 tolerance) {
+        auto viewport   = Viewport::from_lengths(image.lengths);
+        auto band_count = (image.lengths.y() + band_height - 1)/band_height;
+
+        auto batch_count = U32(0);
+
+        auto rasterize_batch = [&](U32 thread, U32 index) {
+            auto& worker = this->workers[thread];
+            auto& entry  = this->batch[index];
+
+            entry.sample_runs.length = 0;
+            worker.rasterizer.sample_runs = &entry.sample_runs;
+            rasterize_path(worker.rasterizer, scene, scene.paths[entry.path], viewport, tolerance, worker.segments);
+        };
+
+        auto composite_band = [&](U32 thread, U32 band) {
+            LPP_UNUSED(thread);
+            auto y_begin = S32(band*band_height);
+            auto y_end   = S32(min((band + 1)*band_height, image.lengths.y()));
+
+            for(auto i : Range<U32>(batch_count)) {
+                const auto& entry = this->batch[i];
+                const auto& path  = scene.paths[entry.path];
+                if(path.bounds_max.y() < F32(y_begin) - 1.0f || path.bounds_min.y() > F32(y_end) + 1.0f) {
+                    continue;
+                }
+
+                auto begin = find_row(entry.sample_runs, y_begin);
+                auto end   = find_row(entry.sample_runs, y_end);
+                if(begin < end) {
+                    composite(image, entry.sample_runs.get_values() + begin, end - begin, *this->lut, scene.get_color(path));
+                }
+            }
+        };
+
+        auto flush = [&]() {
+            this->pool->run(batch_count, rasterize_batch);
+            this->pool->run(band_count,  composite_band);
+            batch_count = 0;
+        };
+
+        for(auto i : Range<U32>(scene.path_count)) {
+            const auto& path = scene.paths[i];
+            if(scene.get_color(path).a() <= 0.0f || is_outside(path, viewport)) {
+                continue;
+            }
+
+            if(batch_count == this->batch.length) {
+                auto& entry = this->batch.append_empty();
+                new (&entry.sample_runs) List<Sample_Run>();
+            }
+            this->batch[batch_count].path = i;
+            batch_count += 1;
+
+            if(batch_count == batch_size) {
+                flush();
+            }
+        }
+
+        if(batch_count > 0) {
+            flush();
+        }
+    }
+
+    Void Scene_Renderer::_destroy() {
+        for(auto& worker : this->workers) {
+            worker.rasterizer._destroy();
+            worker.segments._destroy();
+        }
+        this->workers._destroy();
+
+        for(auto& entry : this->batch) {
+            entry.sample_runs._destroy();
+        }
+        this->batch._destroy();
+    }
+
+}}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "common.hpp"
+#include "msaa.hpp"
+#include "baked_scene.hpp"
+#include "work_pool.hpp"
+
+
+namespace raster {
+namespace msaa {
+
+    /* Scene_Renderer
+        - renders baked scenes on a work pool, with the same result as
+          render.
+        - paths are processed in batches. first the paths of a batch are
+          flattened and rasterized concurrently, each into its own run list.
+          then the image is split into bands of rows, and each band
+          composites the runs of the batch that fall into it in draw order.
+        - the rasterizers and run lists are kept between frames.
+    */
+    struct Scene_Renderer {
+        static constexpr U32 batch_size  = 512;
+        static constexpr U32 band_height = 16;
+
+        struct Worker {
+            Rasterizer rasterizer;
+            List<Segment<V2f>> segments;
+        };
+
+        struct Batch_Path {
+            U32 path;
+            List<Sample_Run> sample_runs;
+        };
+
+        Ptr<Work_Pool> pool;
+        Ptr<const Lut> lut;
+
+        List<Worker>     workers;
+        List<Batch_Path> batch;
+
+
+        static Scene_Renderer create(Ptr<Work_Pool> pool, Ptr<const Lut> lut);
+
+        // scenes without segments are flattened with tolerance.
+        Void render(Ref<Image<Color_Bgra>> image, Ref<const Baked_Scene_View> scene, F32 tolerance);
+
+        Void _destroy();
+
+        Scene_Renderer() {}
+        LPP_MOVE_IS_DESTROY_CTORS(Scene_Renderer, Scene_Renderer);
+    };
+
+}}
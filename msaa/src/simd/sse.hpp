@@ -129,12 +129,18 @@ namespace raster {
 
         F32x4 load()            { return _mm_loadu_ps(reinterpret_cast<Ptr<F32>>(&this->value)); }
         Void store(F32x4 value) { _mm_storeu_ps(reinterpret_cast<Ptr<F32>>(&this->value), value.value); }
+
+
+        U32 high_bits_to_mask() const {
+            return U32(_mm_movemask_ps(this->value));
+        }
     };
 
     inline F32x4 operator+(F32x4 a, F32x4 b) { return _mm_add_ps(a.value, b.value); }
     inline F32x4 operator-(F32x4 a, F32x4 b) { return _mm_sub_ps(a.value, b.value); }
     inline F32x4 operator*(F32x4 a, F32x4 b) { return _mm_mul_ps(a.value, b.value); }
     inline F32x4 operator/(F32x4 a, F32x4 b) { return _mm_div_ps(a.value, b.value); }
+    inline F32x4 operator<=(F32x4 a, F32x4 b) { return _mm_cmple_ps(a.value, b.value); }
 
 
     inline F32x4 shuffle_rgba_to_bgra(F32x4 a) {
@@ -158,6 +164,30 @@ namespace raster {
 
     inline S16x8 unpack_low(U8x16 a, U8x16 b = U8x16()) { return _mm_unpacklo_epi8(a.value, b.value); }
     inline S32x4 unpack_low(S16x8 a, S16x8 b = S16x8()) { return _mm_unpacklo_epi16(a.value, b.value); }
+
+
+    inline U32 _pack(F32x4 color) {
+        auto u8s = pack_with_unsigned_saturation(
+            pack_with_signed_saturation(
+                to_s32s(color)
+            )
+        );
+        return reinterpret_cast<Ref<U32>>(u8s);
+    }
+
+    inline U32 _pack_255(F32x4 color) {
+        return _pack(color * F32x4(255.0f));
+    }
+
+
+    inline F32x4 _unpack(U32 color) {
+        auto u8s = interpret_as_u8s(U32x4(color));
+        return to_f32s(unpack_low(unpack_low(u8s)));
+    }
+
+    inline F32x4 _unpack_255(U32 color) {
+        return _unpack(color) / F32x4(255.0f);
+    }
 }
 
 
@@ -167,5 +197,8 @@ namespace lpp {
 
     template <>
     inline raster::F32x4 max(raster::F32x4 a, raster::F32x4 b) { return _mm_max_ps(a.value, b.value); }
+
+    inline raster::F32x4 sqrt(raster::F32x4 a) { return _mm_sqrt_ps(a.value); }
+    inline raster::F32x4 ceil(raster::F32x4 a) { return _mm_ceil_ps(a.value); }
 }
 
@@ -0,0 +1,368 @@
+#include "stroke.hpp"
+#include "flatten.hpp"
+
+#include <cmath>
+#include <utility>
+
+
+namespace raster {
+
+    constexpr F32 pi = 3.14159265f;
+
+
+    Void Stroker::stroke(
+        Ref<const Baked_Path_View> path,
+        Ref<const Stroke_Style> style,
+        F32 tolerance,
+        Ref<List<Segment<V2f>>> segments
+    ) {
+        if(!(style.width > 0.0f)) {
+            return;
+        }
+
+        this->style      = style;
+        this->half_width = 0.5f*style.width;
+        this->precision  = get_flatten_precision(tolerance);
+        this->segments   = &segments;
+
+        // max arc step, so that the chords stay within precision.
+        auto cos_half_step = 1.0f - this->precision/this->half_width;
+        this->round_step = 0.5f*pi;
+        if(cos_half_step > 0.0f) {
+            this->round_step = min(2.0f*std::acos(cos_half_step), 0.5f*pi);
+        }
+        this->cos_round_step = std::cos(this->round_step);
+
+        for(auto i : Range<U32>(path.sub_path_count)) {
+            this->stroke_sub_path(path, path.sub_paths[i], tolerance);
+        }
+    }
+
+    Void Stroker::stroke(
+        Ref<const Baked_Path_View> path,
+        Ref<const Transform> transform,
+        Ref<const Stroke_Style> style,
+        F32 tolerance,
+        Ref<List<Segment<V2f>>> segments
+    ) {
+        auto first = segments.length;
+        this->stroke(path, style, get_path_space_tolerance(transform, tolerance), segments);
+
+        for(auto i : Range<Usize>(first, segments.length)) {
+            auto& segment = segments[i];
+            segment.p0() = transform.apply(segment.p0());
+            segment.p1() = transform.apply(segment.p1());
+        }
+    }
+
+    Void Stroker::_destroy() {
+        this->flattened._destroy();
+        this->points._destroy();
+        this->is_joint._destroy();
+        this->directions._destroy();
+    }
+
+
+    Void Stroker::stroke_sub_path(Ref<const Baked_Path_View> path, Ref<const Sub_Path> sub_path, F32 tolerance) {
+        if(sub_path.indices.length() == 0) {
+            return;
+        }
+
+        // center line.
+        this->points.length   = 0;
+        this->is_joint.length = 0;
+        for(auto i : sub_path.indices) {
+            auto index = path.indices[i];
+
+            if(i == sub_path.indices._begin) {
+                this->add_point(path.get_first_point(index), true);
+            }
+            else {
+                this->is_joint.last_unchecked() = true;
+            }
+
+            this->flattened.length = 0;
+            switch(index.kind()) {
+                case Curve_Kind::bezier_1: {
+                    this->add_point(path.b1s[index.index()][1], false);
+                } break;
+
+                case Curve_Kind::bezier_2: {
+                    flatten(path.b2s[index.index()], tolerance, this->flattened);
+                } break;
+
+                case Curve_Kind::bezier_3: {
+                    flatten(path.b3s[index.index()], tolerance, this->flattened);
+                } break;
+            }
+            for(const auto& segment : this->flattened) {
+                this->add_point(segment.p1(), false);
+            }
+        }
+
+        auto is_closed = sub_path.is_closed();
+        if(is_closed) {
+            // the closing line is implicit. the start is a joint.
+            if(this->points.length > 1 && equal(this->points.last_unchecked(), this->points[0])) {
+                this->points.length   -= 1;
+                this->is_joint.length -= 1;
+            }
+            else {
+                this->is_joint.last_unchecked() = true;
+            }
+            this->is_joint[0] = true;
+        }
+
+        if(this->points.length < 2) {
+            this->add_dot(this->points[0]);
+            return;
+        }
+
+        auto h = this->half_width;
+
+        this->compute_directions(is_closed);
+        if(is_closed) {
+            this->move_to(this->points[0] + h*rotated_acw(this->directions[0]));
+            this->stroke_side(true);
+            this->line_to(this->pen_start);
+
+            this->reverse_points();
+            this->compute_directions(true);
+
+            this->move_to(this->points[0] + h*rotated_acw(this->directions[0]));
+            this->stroke_side(true);
+            this->line_to(this->pen_start);
+        }
+        else {
+            this->move_to(this->points[0] + h*rotated_acw(this->directions[0]));
+            this->stroke_side(false);
+            this->add_cap(this->points.last_unchecked(), this->directions.last_unchecked());
+
+            this->reverse_points();
+            this->compute_directions(false);
+
+            this->stroke_side(false);
+            this->add_cap(this->points.last_unchecked(), this->directions.last_unchecked());
+            this->line_to(this->pen_start);
+        }
+    }
+
+    Void Stroker::add_point(V2f point, Bool is_joint) {
+        if(this->points.length > 0 && equal(this->points.last_unchecked(), point)) {
+            this->is_joint.last_unchecked() |= U8(is_joint);
+            return;
+        }
+
+        this->points.append_new(point);
+        this->is_joint.append_new(U8(is_joint));
+    }
+
+    Void Stroker::compute_directions(Bool is_closed) {
+        auto count         = U32(this->points.length);
+        auto segment_count = is_closed ? count : count - 1;
+
+        this->directions.reserve(segment_count);
+        this->directions.length = 0;
+        for(auto i : Range<U32>(segment_count)) {
+            auto p0 = this->points[i];
+            auto p1 = this->points[(i + 1) % count];
+            this->directions.append_new(normalized(p1 - p0));
+        }
+    }
+
+    Void Stroker::reverse_points() {
+        auto count = this->points.length;
+        for(auto i : Range<Usize>(count/2)) {
+            std::swap(this->points[i],   this->points[count - 1 - i]);
+            std::swap(this->is_joint[i], this->is_joint[count - 1 - i]);
+        }
+    }
+
+
+    Void Stroker::stroke_side(Bool is_closed) {
+        auto h = this->half_width;
+
+        auto count         = U32(this->points.length);
+        auto segment_count = U32(this->directions.length);
+
+        this->line_to(this->points[0] + h*rotated_acw(this->directions[0]));
+
+        for(auto i : Range<U32>(segment_count)) {
+            auto direction = this->directions[i];
+            auto end       = this->points[(i + 1) % count];
+
+            this->line_to(end + h*rotated_acw(direction));
+
+            if(is_closed || i + 1 < segment_count) {
+                auto next = (i + 1) % segment_count;
+                auto join = this->is_joint[(i + 1) % count] ? this->style.join : Stroke_Join::round;
+
+                auto length_squared_0 = length_squared(end - this->points[i]);
+                auto length_squared_1 = length_squared(this->points[(next + 1) % count] - end);
+                auto min_length_squared = min(length_squared_0, length_squared_1);
+
+                this->add_join(end, direction, this->directions[next], min_length_squared, join);
+            }
+        }
+    }
+
+    Void Stroker::add_join(V2f pivot, V2f d0, V2f d1, F32 min_length_squared, Stroke_Join join) {
+        auto h = this->half_width;
+
+        auto n0 = rotated_acw(d0);
+        auto n1 = rotated_acw(d1);
+        auto to = pivot + h*n1;
+
+        // turning towards this side.
+        if(dot(n0, d1) > 0.0f) {
+            // the offset lines cross h*tan(angle/2) before the ends of the
+            // offset segments, and the chord between the ends reaches
+            // h*sin(angle) along them. if both segments are longer than
+            // that, the chord is covered by the segments and only raises
+            // the winding. tan^2(angle/2) = (1 - cos)/(1 + cos).
+            auto cos_angle = dot(n0, n1);
+            auto h2 = squared(h);
+            if(    h2*(1.0f - cos_angle) > min_length_squared*(1.0f + cos_angle)
+                || h2*(1.0f - squared(cos_angle)) > min_length_squared
+            ) {
+                this->line_to(pivot);
+            }
+            this->line_to(to);
+            return;
+        }
+
+        if(equal(n0, n1)) {
+            return;
+        }
+
+        auto cos_angle = clamp(dot(n0, n1), -1.0f, 1.0f);
+
+        switch(join) {
+            case Stroke_Join::miter: {
+                // miter length / h = 1/cos(angle/2) = sqrt(2/(1 + cos_angle)).
+                auto limit = this->style.miter_limit;
+                if(2.0f <= squared(limit)*(1.0f + cos_angle)) {
+                    this->line_to(pivot + h/(1.0f + cos_angle)*(n0 + n1));
+                }
+            } break;
+
+            case Stroke_Join::round: {
+                // most joins inside curves are a single chord.
+                if(cos_angle >= this->cos_round_step) {
+                    break;
+                }
+
+                // a u-turn goes around the front.
+                auto cross = n0.x()*n1.y() - n0.y()*n1.x();
+                auto sign  = (cross > 0.0f) ? 1.0f : -1.0f;
+                this->add_arc(pivot, n0, std::acos(cos_angle), sign);
+            } break;
+
+            case Stroke_Join::bevel: {
+            } break;
+        }
+
+        this->line_to(to);
+    }
+
+    Void Stroker::add_cap(V2f point, V2f direction) {
+        auto h = this->half_width;
+
+        auto n  = rotated_acw(direction);
+        auto to = point - h*n;
+
+        switch(this->style.cap) {
+            case Stroke_Cap::butt: {
+            } break;
+
+            case Stroke_Cap::round: {
+                // from n through direction, which is n rotated cw.
+                this->add_arc(point, n, pi, -1.0f);
+            } break;
+
+            case Stroke_Cap::square: {
+                auto extension = h*direction;
+                this->line_to(point + h*n + extension);
+                this->line_to(point - h*n + extension);
+            } break;
+        }
+
+        this->line_to(to);
+    }
+
+    Void Stroker::add_dot(V2f point) {
+        auto h = this->half_width;
+
+        // same orientation as the outlines.
+        switch(this->style.cap) {
+            case Stroke_Cap::butt: {
+            } break;
+
+            case Stroke_Cap::round: {
+                this->move_to(point + V2f({ h, 0.0f }));
+                this->add_arc(point, V2f({ 1.0f, 0.0f }), 2.0f*pi, -1.0f);
+                this->line_to(this->pen_start);
+            } break;
+
+            case Stroke_Cap::square: {
+                this->move_to(point + V2f({ -h, -h }));
+                this->line_to(point + V2f({ -h,  h }));
+                this->line_to(point + V2f({  h,  h }));
+                this->line_to(point + V2f({  h, -h }));
+                this->line_to(this->pen_start);
+            } break;
+        }
+    }
+
+    // interior points of the arc from center + h*from, rotating by angle.
+    // sign > 0 rotates acw.
+    Void Stroker::add_arc(V2f center, V2f from, F32 angle, F32 sign) {
+        auto h = this->half_width;
+
+        auto step_count = U32(std::ceil(angle/this->round_step));
+        step_count = min(step_count, flatten_max_segment_count);
+        if(step_count <= 1) {
+            return;
+        }
+
+        auto step = angle/F32(step_count);
+        auto c = std::cos(step);
+        auto s = sign*std::sin(step);
+
+        auto v = from;
+        for(auto i : Range<U32>(1, step_count)) { LPP_UNUSED(i);
+            v = V2f({ v.x()*c - v.y()*s, v.x()*s + v.y()*c });
+            this->line_to(center + h*v);
+        }
+    }
+
+
+    Void Stroker::move_to(V2f p) {
+        this->pen       = p;
+        this->pen_start = p;
+    }
+
+    Void Stroker::line_to(V2f p) {
+        if(equal(this->pen, p)) {
+            return;
+        }
+
+        this->segments->append_new(Segment<V2f>({ this->pen, p }));
+        this->pen = p;
+    }
+
+
+
+    Void stroke(
+        Ref<const Baked_Path_View> path,
+        Ref<const Stroke_Style> style,
+        F32 tolerance,
+        Ref<List<Segment<V2f>>> segments
+    ) {
+        auto stroker = Stroker();
+        stroker.stroke(path, style, tolerance, segments);
+        stroker._destroy();
+    }
+
+}
+
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "common.hpp"
+#include "path.hpp"
+
+
+namespace raster {
+
+    enum class Stroke_Join : U8 {
+        miter,
+        round,
+        bevel,
+    };
+
+    enum class Stroke_Cap : U8 {
+        butt,
+        round,
+        square,
+    };
+
+    struct Stroke_Style {
+        F32 width;
+        Stroke_Join join;
+        Stroke_Cap  cap;
+        // max ratio of miter length to half width. sharper joins are beveled.
+        F32 miter_limit;
+
+        static Stroke_Style make(F32 width) {
+            return Stroke_Style{ width, Stroke_Join::miter, Stroke_Cap::butt, 4.0f };
+        }
+    };
+
+
+    /* Stroker
+        - strokes straight into segments for the non-zero fill rule. there
+          are no intermediate curves.
+        - the center line is flattened with the flatten tolerance, then the
+          polyline is offset to both sides. vertices inside a curve get round
+          joins, which are within tolerance of the true offset curve. the
+          style's join is used between curves and at closed sub-path starts.
+        - open sub-paths become one closed outline: left side, end cap,
+          right side, start cap. closed sub-paths become two outlines.
+        - inner joins connect the offset segments directly. they only go
+          through the center point where a segment is too short for that,
+          for sharp turns or widths large relative to the segments.
+        - the lists are scratch space, reused across calls.
+    */
+    struct Stroker {
+        Stroke_Style style;
+        F32 half_width;
+        F32 precision;
+        F32 round_step;
+        F32 cos_round_step;
+
+        List<Segment<V2f>> flattened;
+        List<V2f> points;
+        List<U8>  is_joint;
+        List<V2f> directions;
+
+        Ptr<List<Segment<V2f>>> segments;
+        V2f pen;
+        V2f pen_start;
+
+
+        Void stroke(
+            Ref<const Baked_Path_View> path,
+            Ref<const Stroke_Style> style,
+            F32 tolerance,
+            Ref<List<Segment<V2f>>> segments
+        );
+
+        // strokes in path space, then transforms the outline. non uniform
+        // scales give an elliptical pen.
+        Void stroke(
+            Ref<const Baked_Path_View> path,
+            Ref<const Transform> transform,
+            Ref<const Stroke_Style> style,
+            F32 tolerance,
+            Ref<List<Segment<V2f>>> segments
+        );
+
+        Void _destroy();
+
+        Stroker() {}
+        LPP_MOVE_IS_DESTROY_CTORS(Stroker, Stroker);
+
+
+        Void stroke_sub_path(Ref<const Baked_Path_View> path, Ref<const Sub_Path> sub_path, F32 tolerance);
+        Void add_point(V2f point, Bool is_joint);
+        Void compute_directions(Bool is_closed);
+        Void reverse_points();
+
+        Void stroke_side(Bool is_closed);
+        Void add_join(V2f pivot, V2f d0, V2f d1, F32 min_length_squared, Stroke_Join join);
+        Void add_cap(V2f point, V2f direction);
+        Void add_dot(V2f point);
+        Void add_arc(V2f center, V2f from, F32 angle, F32 sign);
+
+        Void move_to(V2f p);
+        Void line_to(V2f p);
+    };
+
+    Void stroke(
+        Ref<const Baked_Path_View> path,
+        Ref<const Stroke_Style> style,
+        F32 tolerance,
+        Ref<List<Segment<V2f>>> segments
+    );
+
+}
+
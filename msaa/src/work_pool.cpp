@@ -0,0 +1,209 @@
+#include "work_pool.hpp"
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+
+namespace raster {
+
+    // [begin, end) of the task indices in one atomic. end is in the high
+    // half, begin in the low half.
+    inline U64 pack_range(U32 begin, U32 end) {
+        return (U64(end) << 32) | U64(begin);
+    }
+
+    inline U32 get_begin(U64 range) { return U32(range); }
+    inline U32 get_end  (U64 range) { return U32(range >> 32); }
+
+
+    constexpr Usize cache_line_size = 64;
+
+    // one cache line per queue. the array is aligned by hand, new doesn't
+    // align to more than 16 bytes before c++17.
+    struct Work_Queue {
+        std::atomic<U64> range;
+        U8 padding[cache_line_size - sizeof(std::atomic<U64>)];
+    };
+
+
+    struct Work_Pool_Shared {
+        Ptr<std::thread> threads;
+        Ptr<Work_Queue>  queues;
+        Ptr<Byte>        queue_bytes;
+        U32 thread_count;
+
+        std::mutex              mutex;
+        std::condition_variable job_started;
+        std::condition_variable job_finished;
+
+        Work_Proc proc       = nullptr;
+        Addr      context    = nullptr;
+        U64       generation = 0;
+        U32       active     = 0;
+        Bool      stopping   = false;
+
+
+        // the owner takes from the front.
+        Bool take(U32 thread, Ref<U32> task) {
+            auto& queue = this->queues[thread].range;
+            auto range = queue.load();
+            while(true) {
+                auto begin = get_begin(range);
+                auto end   = get_end(range);
+                if(begin >= end) {
+                    return false;
+                }
+                if(queue.compare_exchange_weak(range, pack_range(begin + 1, end))) {
+                    task = begin;
+                    return true;
+                }
+            }
+        }
+
+        // thieves take the back half. the thief's own range is empty, and
+        // nobody else writes empty ranges, so it can be stored directly.
+        Bool steal(U32 thread, Ref<U32> task) {
+            for(auto offset : Range<U32>(1, this->thread_count)) {
+                auto& victim = this->queues[(thread + offset) % this->thread_count].range;
+                auto range = victim.load();
+                while(true) {
+                    auto begin = get_begin(range);
+                    auto end   = get_end(range);
+                    if(begin >= end) {
+                        break;
+                    }
+
+                    auto split = end - (end - begin + 1)/2;
+                    if(victim.compare_exchange_weak(range, pack_range(begin, split))) {
+                        this->queues[thread].range.store(pack_range(split + 1, end));
+                        task = split;
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        Void work(U32 thread, Work_Proc proc, Addr context) {
+            auto task = U32(0);
+            while(this->take(thread, task) || this->steal(thread, task)) {
+                proc(context, thread, task);
+            }
+        }
+
+        Void worker_main(U32 thread) {
+            auto lock = std::unique_lock<std::mutex>(this->mutex);
+            auto seen_generation = this->generation;
+
+            while(true) {
+                this->job_started.wait(lock, [&]() {
+                    return this->stopping || this->generation != seen_generation;
+                });
+                if(this->stopping) {
+                    return;
+                }
+
+                // a late worker may find the job done already. it finds no
+                // tasks and leaves, run waits for it before the next job.
+                seen_generation = this->generation;
+                auto proc    = this->proc;
+                auto context = this->context;
+                this->active += 1;
+
+                lock.unlock();
+                this->work(thread, proc, context);
+                lock.lock();
+
+                this->active -= 1;
+                if(this->active == 0) {
+                    this->job_finished.notify_all();
+                }
+            }
+        }
+    };
+
+
+
+    Work_Pool Work_Pool::create(U32 thread_count) {
+        thread_count = max(thread_count, U32(1));
+
+        auto shared = new Work_Pool_Shared();
+        shared->thread_count = thread_count;
+        shared->queue_bytes  = new Byte[(thread_count + 1)*cache_line_size];
+        shared->queues       = Ptr<Work_Queue>((Usize(shared->queue_bytes) + cache_line_size - 1) & ~(cache_line_size - 1));
+        shared->threads      = new std::thread[thread_count - 1];
+        for(auto i : Range<U32>(thread_count)) {
+            new (&shared->queues[i]) Work_Queue();
+            shared->queues[i].range.store(0);
+        }
+        for(auto i : Range<U32>(1, thread_count)) {
+            shared->threads[i - 1] = std::thread([shared, i]() { shared->worker_main(i); });
+        }
+
+        auto pool = Work_Pool();
+        pool.shared = shared;
+        return pool;
+    }
+
+    U32 Work_Pool::get_thread_count() const {
+        return this->shared->thread_count;
+    }
+
+    Void Work_Pool::run(U32 task_count, Work_Proc proc, Addr context) {
+        auto& shared = *this->shared;
+
+        if(shared.thread_count == 1 || task_count <= 1) {
+            for(auto task : Range<U32>(task_count)) {
+                proc(context, 0, task);
+            }
+            return;
+        }
+
+        auto lock = std::unique_lock<std::mutex>(shared.mutex);
+
+        // late workers of the previous job must not see the new ranges.
+        shared.job_finished.wait(lock, [&]() { return shared.active == 0; });
+
+        for(auto i : Range<U32>(shared.thread_count)) {
+            auto begin = U32(U64(i)    *task_count/shared.thread_count);
+            auto end   = U32(U64(i + 1)*task_count/shared.thread_count);
+            shared.queues[i].range.store(pack_range(begin, end));
+        }
+
+        shared.proc        = proc;
+        shared.context     = context;
+        shared.generation += 1;
+        shared.job_started.notify_all();
+
+        lock.unlock();
+        shared.work(0, proc, context);
+        lock.lock();
+
+        // the queues are empty, wait for the tasks still running.
+        shared.job_finished.wait(lock, [&]() { return shared.active == 0; });
+    }
+
+    Void Work_Pool::_destroy() {
+        if(this->shared == nullptr) {
+            return;
+        }
+
+        {
+            auto lock = std::unique_lock<std::mutex>(this->shared->mutex);
+            this->shared->stopping = true;
+        }
+        this->shared->job_started.notify_all();
+
+        for(auto i : Range<U32>(this->shared->thread_count - 1)) {
+            this->shared->threads[i].join();
+        }
+
+        delete[] this->shared->threads;
+        delete[] this->shared->queue_bytes;
+        delete this->shared;
+        this->shared = nullptr;
+    }
+
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "common.hpp"
+
+
+namespace raster {
+
+    struct Work_Pool_Shared;
+
+    // called for each task of a job. thread is in [0, thread_count) and
+    // identifies the calling thread, so tasks can use per-thread buffers.
+    using Work_Proc = Void (*)(Addr context, U32 thread, U32 task);
+
+
+    /* Work_Pool
+        - runs the tasks of one job at a time on worker threads. the calling
+          thread works too, as thread 0.
+        - each thread starts with an equal, contiguous range of the tasks and
+          takes them from the front. when its range is empty it steals the
+          back half of another thread's range. ranges are single atomics, so
+          taking and stealing are lock free.
+        - jobs can't spawn tasks. run returns when all tasks are done.
+    */
+    struct Work_Pool {
+        Ptr<Work_Pool_Shared> shared;
+
+
+        // thread_count includes the calling thread. 1 runs everything on
+        // the caller.
+        static Work_Pool create(U32 thread_count);
+
+        U32 get_thread_count() const;
+
+        Void run(U32 task_count, Work_Proc proc, Addr context);
+
+        // f(thread, task).
+        template <typename F>
+        Void run(U32 task_count, Ref<const F> f) {
+            this->run(
+                task_count,
+                [](Addr context, U32 thread, U32 task) { (*Ptr<const F>(context))(thread, task); },
+                Addr(const_cast<Ptr<F>>(&f))
+            );
+        }
+
+        Void _destroy();
+
+        Work_Pool() {}
+        LPP_MOVE_IS_DESTROY_CTORS(Work_Pool, Work_Pool);
+    };
+
+}